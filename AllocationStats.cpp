@@ -0,0 +1,40 @@
+﻿#include "AllocationStats.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef NC_ALLOCATION_STATS
+
+namespace {
+    // Свой счетчик у каждого потока: кадр сцены меряет только главный поток
+    thread_local std::size_t allocationCount = 0;
+}
+
+std::size_t AllocationStats::getCount() {
+    return allocationCount;
+}
+
+// Массивы по умолчанию идут через эти функции; sized delete заменяется отдельно,
+// иначе компилятор может освободить память мимо нашего malloc
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#else
+
+std::size_t AllocationStats::getCount() {
+    return 0;
+}
+
+#endif
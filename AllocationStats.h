@@ -0,0 +1,24 @@
+﻿// AllocationStats.h
+#pragma once
+#include <cstddef>
+
+// Глобальный operator new подменяется только в отладочной сборке или с NC_ALLOCATION_STATS;
+// в релизе куча не трогается, а счетчик всегда равен нулю
+#if !defined(NC_ALLOCATION_STATS) && !defined(NDEBUG)
+#define NC_ALLOCATION_STATS 1
+#endif
+
+// Счетчик обращений к куче через глобальный operator new. Сцены сравнивают значения
+// до и после кадра, чтобы убедиться, что в установившемся режиме кадр ничего не выделяет
+namespace AllocationStats {
+    constexpr bool isEnabled() {
+#ifdef NC_ALLOCATION_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Выделения вызывающего потока: поток загрузчика ассетов в счет главного не попадает
+    std::size_t getCount();
+}
@@ -0,0 +1,72 @@
+﻿#include "AppearanceCompositeCache.h"
+#include <algorithm>
+#include <iostream>
+
+AppearanceCompositeCache::AppearanceCompositeCache(std::size_t capacity)
+    : capacity(std::max<std::size_t>(1, capacity)) {
+}
+
+const sf::Texture* AppearanceCompositeCache::find(std::uint64_t key) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    stats.hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return &it->second->target->getTexture();
+}
+
+sf::RenderTexture* AppearanceCompositeCache::acquire(std::uint64_t key, sf::Vector2u size) {
+    if (size.x == 0 || size.y == 0) return nullptr;
+
+    // Повторное запекание того же ключа перезаписывает запись на месте
+    auto existing = index.find(key);
+    if (existing != index.end()) {
+        entries.splice(entries.begin(), entries, existing->second);
+    }
+    else {
+        std::unique_ptr<sf::RenderTexture> target;
+        if (entries.size() >= capacity) {
+            // Вытесняем самую старую, ее RenderTexture забираем себе
+            Entry& oldest = entries.back();
+            index.erase(oldest.key);
+            target = std::move(oldest.target);
+            entries.pop_back();
+            stats.evictions++;
+        }
+
+        if (!target) {
+            target = std::make_unique<sf::RenderTexture>();
+        }
+        entries.push_front({ key, std::move(target) });
+        index[key] = entries.begin();
+    }
+
+    sf::RenderTexture& target = *entries.front().target;
+    if (target.getSize() != size && !target.resize(size)) {
+        std::cerr << "AppearanceCompositeCache: could not create " << size.x << "x" << size.y
+            << " render texture" << std::endl;
+        index.erase(key);
+        entries.pop_front();
+        return nullptr;
+    }
+
+    target.clear(sf::Color::Transparent);
+    return &target;
+}
+
+void AppearanceCompositeCache::clear() {
+    entries.clear();
+    index.clear();
+}
+
+std::size_t AppearanceCompositeCache::getTextureBytes() const {
+    std::size_t bytes = 0;
+    for (const auto& entry : entries) {
+        auto size = entry.target->getSize();
+        bytes += static_cast<std::size_t>(size.x) * size.y * 4;
+    }
+    return bytes;
+}
@@ -0,0 +1,48 @@
+﻿// AppearanceCompositeCache.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+// Небольшой LRU-кэш запеченных изображений персонажа.
+// Ключ — хеш CharacterAppearance, значение — RenderTexture с уже собранными слоями.
+// Вытесненная текстура переиспользуется под новую запись, если подходит по размеру.
+class AppearanceCompositeCache {
+public:
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+    };
+
+    explicit AppearanceCompositeCache(std::size_t capacity = 8);
+
+    // Готовая текстура или nullptr; попадание поднимает запись в начало списка
+    const sf::Texture* find(std::uint64_t key);
+
+    // Цель для запекания новой записи (очищенная, прозрачная) или nullptr, если RenderTexture не создалась.
+    // После отрисовки слоев вызывающий должен сделать display()
+    sf::RenderTexture* acquire(std::uint64_t key, sf::Vector2u size);
+
+    void clear();
+
+    std::size_t getSize() const { return entries.size(); }
+    std::size_t getCapacity() const { return capacity; }
+    std::size_t getTextureBytes() const;
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = {}; }
+
+private:
+    struct Entry {
+        std::uint64_t key = 0;
+        std::unique_ptr<sf::RenderTexture> target;
+    };
+
+    std::list<Entry> entries;   // в начале — самые свежие
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+    std::size_t capacity;
+    Stats stats;
+};
@@ -0,0 +1,211 @@
+﻿#include "AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    std::string_view stripDotSlash(std::string_view name) {
+        while (name.size() >= 2 && name[0] == '.' && (name[1] == '/' || name[1] == '\\')) {
+            name.remove_prefix(2);
+        }
+        return name;
+    }
+
+    char normalizeChar(char c) {
+        return c == '\\' ? '/' : c;
+    }
+
+    // Сравнение сохраненного (уже нормализованного) имени с запросом без аллокаций
+    bool sameName(std::string_view stored, std::string_view query) {
+        query = stripDotSlash(query);
+        if (stored.size() != query.size()) return false;
+        for (std::size_t i = 0; i < query.size(); ++i) {
+            if (stored[i] != normalizeChar(query[i])) return false;
+        }
+        return true;
+    }
+}
+
+AssetArchive& AssetArchive::instance() {
+    static AssetArchive archive;
+    static const bool opened = archive.open(DEFAULT_PATH);
+    (void)opened;
+    return archive;
+}
+
+AssetArchive::~AssetArchive() {
+    close();
+}
+
+std::uint64_t AssetArchive::hashName(std::string_view name) {
+    name = stripDotSlash(name);
+
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash ^= static_cast<std::uint8_t>(normalizeChar(c));
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string AssetArchive::normalizeName(std::string_view name) {
+    name = stripDotSlash(name);
+
+    std::string result(name);
+    std::replace(result.begin(), result.end(), '\\', '/');
+    return result;
+}
+
+bool AssetArchive::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cout << "AssetArchive: " << path << " not found, using loose files" << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        std::cerr << "AssetArchive: could not map " << path << std::endl;
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "AssetArchive: " << path << " not found, using loose files" << std::endl;
+        return false;
+    }
+
+    struct stat st {};
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // Дескриптор после mmap больше не нужен
+    ::close(fd);
+
+    if (view == MAP_FAILED) {
+        std::cerr << "AssetArchive: could not map " << path << std::endl;
+        return false;
+    }
+
+    mappedSize = static_cast<std::size_t>(st.st_size);
+#endif
+
+    base = static_cast<const std::uint8_t*>(view);
+
+    // Проверяем заголовок и границы таблиц, чтобы битый архив не привел к чтению за пределами.
+    // Смещения 64-битные и приходят из файла: сравниваем с остатком, а не сумму, чтобы она не переполнилась
+    Header header{};
+    bool valid = mappedSize >= sizeof(Header);
+    if (valid) {
+        std::memcpy(&header, base, sizeof(Header));
+        valid = std::memcmp(header.magic, "NCPK", 4) == 0
+            && header.version == VERSION
+            && header.indexOffset % alignof(Entry) == 0
+            && header.indexOffset <= mappedSize
+            && header.entryCount <= (mappedSize - header.indexOffset) / sizeof(Entry)
+            && header.namesOffset <= mappedSize;
+    }
+
+    if (valid) {
+        entries = reinterpret_cast<const Entry*>(base + header.indexOffset);
+        names = reinterpret_cast<const char*>(base + header.namesOffset);
+        entryCount = header.entryCount;
+
+        std::uint64_t namesSize = mappedSize - header.namesOffset;
+        for (std::uint32_t i = 0; i < entryCount && valid; ++i) {
+            const Entry& e = entries[i];
+            valid = e.offset <= mappedSize && e.size <= mappedSize - e.offset
+                && static_cast<std::uint64_t>(e.nameOffset) + e.nameLength <= namesSize
+                && (i == 0 || entries[i - 1].hash <= e.hash);
+        }
+    }
+
+    if (!valid) {
+        std::cerr << "AssetArchive: " << path << " is corrupt or has an unsupported version" << std::endl;
+        close();
+        return false;
+    }
+
+    std::cout << "AssetArchive: mapped " << path << " (" << entryCount << " entries, "
+        << mappedSize / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+void AssetArchive::close() {
+    if (base) {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<std::uint8_t*>(base), mappedSize);
+#endif
+    }
+
+    base = nullptr;
+    mappedSize = 0;
+    entries = nullptr;
+    names = nullptr;
+    entryCount = 0;
+}
+
+bool AssetArchive::owns(std::string_view path) const {
+    if (!base) return false;
+
+    path = stripDotSlash(path);
+    std::string_view root(ASSET_ROOT);
+    if (path.size() < root.size()) return false;
+    for (std::size_t i = 0; i < root.size(); ++i) {
+        if (normalizeChar(path[i]) != root[i]) return false;
+    }
+    return true;
+}
+
+std::string_view AssetArchive::getName(std::size_t index) const {
+    if (index >= entryCount) return {};
+    return std::string_view(names + entries[index].nameOffset, entries[index].nameLength);
+}
+
+std::optional<AssetArchive::Blob> AssetArchive::find(std::string_view name) const {
+    if (!base) return std::nullopt;
+
+    std::uint64_t hash = hashName(name);
+    const Entry* end = entries + entryCount;
+    const Entry* it = std::lower_bound(entries, end, hash,
+        [](const Entry& e, std::uint64_t h) { return e.hash < h; });
+
+    for (; it != end && it->hash == hash; ++it) {
+        std::string_view stored(names + it->nameOffset, it->nameLength);
+        if (sameName(stored, name)) {
+            return Blob{ base + it->offset, static_cast<std::size_t>(it->size) };
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,80 @@
+﻿// AssetArchive.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Упакованный архив ассетов (assets.pak), собирается утилитой tools/AssetPacker.
+// Файл отображается в память целиком; find() ищет имя в отсортированном
+// по хешу индексе и возвращает указатель прямо в отображение, без копий и открытий файлов.
+class AssetArchive {
+public:
+    // Формат на диске (little-endian)
+    struct Header {
+        char magic[4];              // "NCPK"
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        std::uint32_t reserved;
+        std::uint64_t indexOffset;  // Entry[entryCount], отсортированы по hash
+        std::uint64_t namesOffset;  // имена подряд, для проверки коллизий
+    };
+
+    struct Entry {
+        std::uint64_t hash;
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint32_t nameOffset;
+        std::uint32_t nameLength;
+    };
+
+    static_assert(sizeof(Header) == 32, "AssetArchive::Header layout");
+    static_assert(sizeof(Entry) == 32, "AssetArchive::Entry layout");
+
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t DATA_ALIGNMENT = 16;
+    static constexpr const char* DEFAULT_PATH = "assets.pak";
+    static constexpr const char* ASSET_ROOT = "assets/";
+
+    struct Blob {
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    // Процессный архив; при первом обращении пробует открыть DEFAULT_PATH
+    static AssetArchive& instance();
+
+    AssetArchive() = default;
+    ~AssetArchive();
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    std::optional<Blob> find(std::string_view name) const;
+
+    // Если архив смонтирован, пути внутри assets/ обслуживаются только им,
+    // и загрузчики не пытаются открыть такие файлы с диска
+    bool owns(std::string_view path) const;
+    std::size_t getEntryCount() const { return entryCount; }
+    std::string_view getName(std::size_t index) const;
+
+    // FNV-1a по нормализованному имени ('\\' считается '/', "./" в начале отбрасывается)
+    static std::uint64_t hashName(std::string_view name);
+    static std::string normalizeName(std::string_view name);
+
+private:
+    const std::uint8_t* base = nullptr;
+    std::size_t mappedSize = 0;
+    const Entry* entries = nullptr;
+    const char* names = nullptr;
+    std::uint32_t entryCount = 0;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
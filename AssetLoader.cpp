@@ -0,0 +1,212 @@
+﻿#include "AssetLoader.h"
+#include "ResourceCache.h"
+#include "AssetArchive.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+AssetLoader& AssetLoader::instance() {
+    static AssetLoader loader;
+    return loader;
+}
+
+AssetLoader::~AssetLoader() {
+    shutdown();
+}
+
+void AssetLoader::startWorkers() {
+    if (!workers.empty()) return;
+
+    // Один поток оставляем под рендер, больше четырех для десятка файлов не нужно
+    unsigned int hw = std::thread::hardware_concurrency();
+    unsigned int count = std::clamp(hw > 1 ? hw - 1 : 1u, 1u, 4u);
+
+    for (unsigned int i = 0; i < count; ++i) {
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+    }
+    std::cout << "AssetLoader: started " << count << " worker threads" << std::endl;
+}
+
+void AssetLoader::preload(const std::vector<std::string>& ids) {
+    auto& cache = ResourceCache::instance();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& id : ids) {
+            // Тип определяем по префиксу логического ID
+            Kind kind = id.rfind("font.", 0) == 0 ? Kind::Font : Kind::Texture;
+            bool cached = kind == Kind::Font ? cache.hasFont(id) : cache.hasTexture(id);
+            if (cached) continue;
+
+            jobs.push_back({ id, kind, cache.candidatePaths(id), nullptr });
+            totalRequested++;
+        }
+    }
+
+    startWorkers();
+    jobAvailable.notify_all();
+}
+
+void AssetLoader::requestImage(std::vector<std::string> paths, ImageCallback onReady, bool urgent) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Job job{ paths.empty() ? std::string() : paths.front(), Kind::Image, std::move(paths), std::move(onReady) };
+        if (urgent) {
+            jobs.push_front(std::move(job));
+        }
+        else {
+            jobs.push_back(std::move(job));
+        }
+    }
+
+    startWorkers();
+    jobAvailable.notify_one();
+}
+
+void AssetLoader::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        Decoded result = decode(job);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            decoded.push_back(std::move(result));
+        }
+    }
+}
+
+AssetLoader::Decoded AssetLoader::decode(const Job& job) const {
+    Decoded result;
+    result.id = job.id;
+    result.kind = job.kind;
+    result.onImage = job.onImage;
+
+    auto& archive = AssetArchive::instance();
+    for (const auto& path : job.paths) {
+        if (auto blob = archive.find(path)) {
+            // Из архива: картинку декодируем из отображения, шрифт не копируем вовсе
+            if (job.kind != Kind::Font) {
+                sf::Image image;
+                if (image.loadFromMemory(blob->data, blob->size)) {
+                    result.image = std::move(image);
+                    result.ok = true;
+                    break;
+                }
+            }
+            else {
+                result.mapped = blob->data;
+                result.mappedSize = blob->size;
+                result.ok = true;
+                break;
+            }
+            continue;
+        }
+
+        if (archive.owns(path)) continue;
+
+        if (job.kind != Kind::Font) {
+            // Декодирование PNG/JPG целиком на рабочем потоке
+            sf::Image image;
+            if (image.loadFromFile(path)) {
+                result.image = std::move(image);
+                result.ok = true;
+                break;
+            }
+        }
+        else {
+            // Шрифт просто читаем в память, openFromMemory сделает главный поток
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in.is_open()) continue;
+
+            std::streamsize size = in.tellg();
+            if (size <= 0) continue;
+
+            result.bytes.resize(static_cast<std::size_t>(size));
+            in.seekg(0);
+            if (in.read(reinterpret_cast<char*>(result.bytes.data()), size)) {
+                result.ok = true;
+                break;
+            }
+            result.bytes.clear();
+        }
+    }
+
+    return result;
+}
+
+std::size_t AssetLoader::pump(sf::Time budget) {
+    auto& cache = ResourceCache::instance();
+    sf::Clock clock;
+    std::size_t delivered = 0;
+
+    while (clock.getElapsedTime() < budget) {
+        Decoded item;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (decoded.empty()) break;
+            item = std::move(decoded.front());
+            decoded.pop_front();
+        }
+
+        if (!item.ok) {
+            std::cerr << "AssetLoader: could not load '" << item.id << "'" << std::endl;
+        }
+
+        // Картинки по запросу отдаются владельцу запроса, мимо кэша и счетчика прогресса
+        if (item.kind == Kind::Image) {
+            if (item.onImage) item.onImage(std::move(item.image));
+            delivered++;
+            continue;
+        }
+
+        // Пустой результат тоже кладем в кэш, чтобы сцены не повторяли неудачные открытия
+        if (item.kind == Kind::Texture) {
+            cache.adoptTexture(item.id, item.image ? *item.image : sf::Image());
+        }
+        else if (item.mapped) {
+            cache.adoptFont(item.id, item.mapped, item.mappedSize);
+        }
+        else {
+            cache.adoptFont(item.id, std::move(item.bytes));
+        }
+
+        completed++;
+        delivered++;
+    }
+    return delivered;
+}
+
+float AssetLoader::getProgress() const {
+    if (totalRequested == 0) return 1.f;
+    return static_cast<float>(completed) / static_cast<float>(totalRequested);
+}
+
+bool AssetLoader::isIdle() const {
+    return completed == totalRequested;
+}
+
+std::size_t AssetLoader::getPendingCount() const {
+    return totalRequested - completed;
+}
+
+void AssetLoader::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    workers.clear();
+}
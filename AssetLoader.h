@@ -0,0 +1,81 @@
+﻿// AssetLoader.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Фоновая загрузка ассетов.
+// Рабочие потоки декодируют картинки в sf::Image и читают шрифты в память,
+// а главный поток в pump() только загружает готовое в GPU и кладет в ResourceCache.
+class AssetLoader {
+public:
+    static AssetLoader& instance();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    ~AssetLoader();
+
+    // Ставит логические ID в очередь; уже закэшированные пропускаются
+    void preload(const std::vector<std::string>& ids);
+
+    // Декодирует первую найденную из paths картинку в sf::Image без загрузки в GPU.
+    // onReady вызывается из pump() в главном потоке (nullopt — ни один путь не подошел).
+    // urgent ставит запрос в начало очереди. В getProgress() такие запросы не входят
+    using ImageCallback = std::function<void(std::optional<sf::Image>&&)>;
+    void requestImage(std::vector<std::string> paths, ImageCallback onReady, bool urgent = false);
+
+    // Вызывается раз в кадр из главного потока; тратит не больше budget на загрузку в GPU.
+    // Возвращает число выданных ассетов, чтобы статичная сцена знала, что пора перерисоваться
+    std::size_t pump(sf::Time budget);
+
+    float getProgress() const;
+    bool isIdle() const;
+    std::size_t getPendingCount() const;
+
+    void shutdown();
+
+private:
+    enum class Kind { Texture, Font, Image };
+
+    struct Job {
+        std::string id;
+        Kind kind;
+        std::vector<std::string> paths;
+        ImageCallback onImage;
+    };
+
+    struct Decoded {
+        std::string id;
+        Kind kind;
+        ImageCallback onImage;
+        bool ok = false;
+        std::optional<sf::Image> image;
+        std::vector<std::uint8_t> bytes;
+        const std::uint8_t* mapped = nullptr;   // шрифт из AssetArchive
+        std::size_t mappedSize = 0;
+    };
+
+    AssetLoader() = default;
+
+    void startWorkers();
+    void workerLoop();
+    Decoded decode(const Job& job) const;
+
+    std::vector<std::thread> workers;
+    std::deque<Job> jobs;
+    std::deque<Decoded> decoded;
+    mutable std::mutex mutex;
+    std::condition_variable jobAvailable;
+    bool stopping = false;
+
+    std::size_t totalRequested = 0;
+    std::size_t completed = 0;
+};
@@ -0,0 +1,186 @@
+﻿#include "AssetManifest.h"
+#include "AssetArchive.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Логический ID -> пути, которые пробуем по порядку
+    const std::vector<std::pair<std::string, std::vector<std::string>>> ASSET_PATHS = {
+        {"font.ui", {
+            "assets/fonts/digital-7 (italic).ttf",
+            "arial.ttf",
+            "../assets/fonts/arial.ttf",
+#ifdef _WIN32
+            // Системные шрифты есть только на Windows, на других ОС эти пути не проверяем
+            "C:\\Windows\\Fonts\\arial.ttf",
+            "C:\\Windows\\Fonts\\calibri.ttf"
+#endif
+        }},
+        {"tex.menu", {"assets/textures/menu.png"}},
+        {"tex.splash", {"assets/textures/splash_background.jpg"}},
+        {"tex.settings", {"assets/textures/SettingsMenu.png"}},
+        {"tex.card.punk", {"assets/textures/z.png"}},
+        {"tex.card.corpo", {"assets/textures/corpo.png"}},
+        {"tex.card.street", {"assets/textures/street.png"}},
+        {"tex.card.tech", {"assets/textures/tech.png"}}
+    };
+
+    // Папки, которые обходятся при старте; пути внутри них проверяются только по списку
+    const std::vector<std::string> SCAN_ROOTS = { "assets/", "character_parts/" };
+
+    // Части персонажа: "<корень><папка>/<имя>.png" -> "char.<папка>.<имя>".
+    // Корни по убыванию приоритета: при совпадении имен побеждает первый
+    const std::vector<std::string> CHARACTER_PART_ROOTS = {
+        "assets/character_parts/",
+        "assets/characters/",
+        "assets/sprites/character/",
+        "character_parts/"
+    };
+
+    bool startsWith(const std::string& value, const std::string& prefix) {
+        return value.compare(0, prefix.size(), prefix) == 0;
+    }
+}
+
+AssetManifest& AssetManifest::instance() {
+    static AssetManifest manifest;
+    static const bool built = (manifest.build(), true);
+    (void)built;
+    return manifest;
+}
+
+void AssetManifest::build() {
+    auto start = std::chrono::steady_clock::now();
+
+    files.clear();
+    resolved.clear();
+    known.clear();
+
+    // Смонтированный архив сам является списком файлов assets/
+    auto& archive = AssetArchive::instance();
+    for (std::size_t i = 0; i < archive.getEntryCount(); ++i) {
+        files.insert(std::string(archive.getName(i)));
+    }
+
+    // Готовый список отвечает только за те корни, файлы из которых в нем есть;
+    // остальные (например, character_parts/ рядом с assets/) обходятся как обычно
+    listedRoots.clear();
+    listingFromFile = loadListing(MANIFEST_PATH);
+    scanDirectories();
+
+    resolveRules();
+    resolveCharacterParts();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "AssetManifest: " << files.size() << " files from "
+        << (archive.isOpen() ? "archive + " : "") << (listingFromFile ? std::string(MANIFEST_PATH) + " + " : std::string()) << "directory scan"
+        << ", resolved " << resolved.size() << " ids in " << elapsed.count() / 1000.0 << " ms" << std::endl;
+}
+
+bool AssetManifest::loadListing(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) return false;
+
+    // Одна строка — один путь относительно папки игры
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        std::string normalized = AssetArchive::normalizeName(line);
+        for (const auto& root : SCAN_ROOTS) {
+            if (startsWith(normalized, root)) listedRoots.insert(root);
+        }
+        files.insert(std::move(normalized));
+    }
+    return true;
+}
+
+void AssetManifest::scanDirectories() {
+    auto& archive = AssetArchive::instance();
+
+    for (const auto& root : SCAN_ROOTS) {
+        // Содержимое assets/ при смонтированном архиве уже известно из его индекса
+        if (archive.owns(root) || listedRoots.count(root) > 0) continue;
+
+        std::error_code error;
+        if (!fs::is_directory(root, error)) continue;
+
+        for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+            if (it->is_regular_file(error)) {
+                files.insert(AssetArchive::normalizeName(it->path().generic_string()));
+            }
+        }
+    }
+}
+
+bool AssetManifest::isListed(const std::string& path) const {
+    return files.count(AssetArchive::normalizeName(path)) > 0;
+}
+
+bool AssetManifest::exists(const std::string& path) const {
+    if (isListed(path)) return true;
+
+    // Пути внутри обходимых папок решает список; остальные (системные шрифты и т.п.) проверяем на диске
+    std::string normalized = AssetArchive::normalizeName(path);
+    for (const auto& root : SCAN_ROOTS) {
+        if (startsWith(normalized, root)) return false;
+    }
+
+    std::error_code error;
+    return fs::is_regular_file(path, error);
+}
+
+void AssetManifest::resolveRules() {
+    for (const auto& [id, candidates] : ASSET_PATHS) {
+        known.insert(id);
+        for (const auto& path : candidates) {
+            if (exists(path)) {
+                resolved[id] = path;
+                break;
+            }
+        }
+
+        if (resolved.count(id) == 0) {
+            // Файл мог появиться после генерации списка: сам список его уже не увидит
+            std::cerr << "AssetManifest: no file for '" << id << "'"
+                << (listingFromFile ? std::string(", regenerate ") + MANIFEST_PATH + " with AssetPacker --manifest" : std::string())
+                << std::endl;
+        }
+    }
+}
+
+void AssetManifest::resolveCharacterParts() {
+    for (const auto& root : CHARACTER_PART_ROOTS) {
+        for (const auto& file : files) {
+            if (!startsWith(file, root)) continue;
+
+            // Ожидаем ровно "<папка>/<имя>.png"
+            std::string rest = file.substr(root.size());
+            auto slash = rest.find('/');
+            if (slash == std::string::npos || rest.find('/', slash + 1) != std::string::npos) continue;
+            if (rest.size() < 4 || rest.compare(rest.size() - 4, 4, ".png") != 0) continue;
+
+            std::string folder = rest.substr(0, slash);
+            std::string name = rest.substr(slash + 1, rest.size() - slash - 1 - 4);
+            std::string id = "char." + folder + "." + name;
+
+            known.insert(id);
+            resolved.emplace(id, file);
+        }
+    }
+}
+
+std::optional<std::string> AssetManifest::resolve(const std::string& id) const {
+    auto it = resolved.find(id);
+    if (it == resolved.end()) return std::nullopt;
+    return it->second;
+}
+
+bool AssetManifest::isKnown(const std::string& id) const {
+    return known.count(id) > 0;
+}
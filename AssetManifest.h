@@ -0,0 +1,50 @@
+﻿// AssetManifest.h
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Разрешение логических ID ассетов ("font.ui", "char.hair.long_black") в конкретные пути.
+// При старте один раз собирается список файлов: из assets.pak, из готового списка
+// assets.manifest (AssetPacker --manifest) и обходом папок, которых нет ни в том, ни в другом. После этого загрузчики
+// делают один поиск в таблице вместо серии неудачных открытий.
+class AssetManifest {
+public:
+    static constexpr const char* MANIFEST_PATH = "assets.manifest";
+
+    // Процессный манифест; при первом обращении строится
+    static AssetManifest& instance();
+
+    AssetManifest(const AssetManifest&) = delete;
+    AssetManifest& operator=(const AssetManifest&) = delete;
+
+    // Собирает список файлов и разрешает все известные ID; повторный вызов пересобирает
+    void build();
+
+    std::optional<std::string> resolve(const std::string& id) const;
+
+    // ID из таблицы правил, даже если файл для него не нашелся
+    bool isKnown(const std::string& id) const;
+
+    std::size_t getFileCount() const { return files.size(); }
+    std::size_t getResolvedCount() const { return resolved.size(); }
+
+private:
+    AssetManifest() = default;
+
+    bool loadListing(const std::string& path);
+    void scanDirectories();
+    bool isListed(const std::string& path) const;
+    bool exists(const std::string& path) const;
+    void resolveRules();
+    void resolveCharacterParts();
+
+    std::unordered_set<std::string> files;              // нормализованные пути из списка
+    std::unordered_map<std::string, std::string> resolved;
+    std::unordered_set<std::string> known;
+    std::unordered_set<std::string> listedRoots;        // корни обхода, которые покрывает готовый список
+    bool listingFromFile = false;
+};
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
+#include <cmath>
+#include <algorithm>
 #include <Scene.h>
 #include <SFML/Window/Event.hpp>
 #include <SFML/Graphics.hpp>
@@ -15,26 +17,50 @@
 #include <CharacterAppearance.h>
 #include "SaveManager.h"
 #include "SceneManager.h"
+#include "ResourceCache.h"
+#include "AssetArchive.h"
+#include "AssetLoader.h"
+#include "AssetManifest.h"
+#include "Input.h"
+
+namespace {
+    // Слои в RenderTexture запекаются поверх прозрачного фона, поэтому цвет там уже умножен на альфу
+    const sf::BlendMode PREMULTIPLIED_ALPHA(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha);
+
+    constexpr int APPEARANCE_OPTIONS = 3;
+    constexpr int APPEARANCE_FIELDS = 6;
+
+    // Сколько места (атлас + маски в памяти) могут занимать загруженные части
+    constexpr std::size_t PART_MEMORY_BUDGET = 32 * 1024 * 1024;
+
+    // Палитры перекраски: тень, основной цвет, блик. Порядок совпадает с опциями в AppearanceScene,
+    // новый цвет — это новая строка здесь, без новых картинок
+    struct PaletteRamp {
+        sf::Color shadow;
+        sf::Color base;
+        sf::Color highlight;
+    };
 
-CharacterPart::CharacterPart() : sprite(texture) {}
-
-bool CharacterPart::loadFromFile(const std::string& path) {
-    if (texture.loadFromFile(path)) {
-        sprite.setTexture(texture);
-        isLoaded = true;
-        std::cout << "Successfully loaded: " << path << std::endl;
-        return true;
-    }
-    std::cerr << "Failed to load: " << path << std::endl;
-    return false;
-}
+    const std::vector<PaletteRamp> HAIR_COLORS = {
+        { sf::Color(8, 8, 10), sf::Color(35, 32, 34), sf::Color(95, 90, 100) },        // Black
+        { sf::Color(40, 22, 12), sf::Color(105, 62, 34), sf::Color(185, 130, 85) },    // Brown
+        { sf::Color(120, 90, 40), sf::Color(215, 180, 105), sf::Color(255, 240, 190) } // Blonde
+    };
 
-void CharacterPart::setPosition(sf::Vector2f pos) {
-    sprite.setPosition(pos);
-}
+    const std::vector<PaletteRamp> SKIN_TONES = {
+        { sf::Color(170, 120, 100), sf::Color(240, 205, 180), sf::Color(255, 238, 225) }, // Light
+        { sf::Color(115, 70, 45), sf::Color(190, 135, 95), sf::Color(235, 190, 150) },    // Medium
+        { sf::Color(45, 25, 15), sf::Color(105, 65, 42), sf::Color(165, 115, 85) }        // Dark
+    };
 
-void CharacterPart::setScale(sf::Vector2f scale) {
-    sprite.setScale(scale);
+    std::vector<RecolorPalette> buildPalettes(const std::vector<PaletteRamp>& ramps) {
+        std::vector<RecolorPalette> palettes;
+        palettes.reserve(ramps.size());
+        for (const auto& ramp : ramps) {
+            palettes.push_back(RecolorPalette::fromRamp(ramp.shadow, ramp.base, ramp.highlight));
+        }
+        return palettes;
+    }
 }
 
 // ModularCharacterSpriteManager Implementation
@@ -67,108 +93,430 @@ void ModularCharacterSpriteManager::createFallbackTexture() {
     }
 }
 
-bool ModularCharacterSpriteManager::loadPartCategory(PartType partType, const std::string& folderName,
+bool ModularCharacterSpriteManager::addPartCategory(PartType partType, const std::string& folderName,
     const std::vector<std::string>& partNames) {
     size_t typeIndex = static_cast<size_t>(partType);
     characterParts[typeIndex].clear();
 
-    std::cout << "Loading " << folderName << " parts..." << std::endl;
-
     for (const auto& partName : partNames) {
+        auto path = resolvePartPath(folderName, partName);
+        if (!path) {
+            std::cerr << "Could not find any variant of: " << partName << std::endl;
+            continue;
+        }
+
         CharacterPart part;
+        part.sourceIndex = static_cast<int>(partSources.size());
+        partSources.push_back({ *path, false });
+        characterParts[typeIndex].push_back(part);
+    }
 
-        // Попробуем разные варианты путей
-        std::vector<std::string> possiblePaths = {
-            "assets/character_parts/" + folderName + "/" + partName + ".png",
-            "assets/characters/" + folderName + "/" + partName + ".png",
-            "assets/sprites/character/" + folderName + "/" + partName + ".png",
-            "character_parts/" + folderName + "/" + partName + ".png"
-        };
-
-        bool loaded = false;
-        for (const auto& path : possiblePaths) {
-            if (part.loadFromFile(path)) {
-                loaded = true;
-                break;
-            }
+    std::cout << "Found " << characterParts[typeIndex].size() << " " << folderName << " parts" << std::endl;
+    return !characterParts[typeIndex].empty();
+}
+
+bool ModularCharacterSpriteManager::addRecolorCategory(PartType partType, const std::string& folderName,
+    const std::vector<std::string>& styleNames, const std::vector<RecolorPalette>& palettes) {
+    // Маски нужны для всех стилей сразу, иначе индексы вариантов разъедутся
+    std::vector<std::string> maskPaths;
+    for (const auto& style : styleNames) {
+        auto path = resolvePartPath(folderName, style + "_mask");
+        if (!path) {
+            std::cout << "No " << folderName << " mask for " << style << ", using per-colour images" << std::endl;
+            return false;
         }
+        maskPaths.push_back(*path);
+    }
+
+    size_t typeIndex = static_cast<size_t>(partType);
+    characterParts[typeIndex].clear();
+
+    int firstPalette = static_cast<int>(recolorPalettes.size());
+    recolorPalettes.insert(recolorPalettes.end(), palettes.begin(), palettes.end());
 
-        if (loaded) {
-            characterParts[typeIndex].push_back(std::move(part));
+    // Индекс варианта = стиль * число палитр + цвет, как и у отдельных картинок
+    for (const auto& maskPath : maskPaths) {
+        int sourceIndex = static_cast<int>(partSources.size());
+        partSources.push_back({ maskPath, true });
+
+        for (size_t i = 0; i < palettes.size(); ++i) {
+            CharacterPart part;
+            part.sourceIndex = sourceIndex;
+            part.paletteIndex = firstPalette + static_cast<int>(i);
+            characterParts[typeIndex].push_back(part);
         }
-        else {
-            std::cerr << "Could not load any variant of: " << partName << std::endl;
+    }
+
+    std::cout << "Found " << styleNames.size() << " " << folderName << " masks for "
+        << characterParts[typeIndex].size() << " colour variants" << std::endl;
+    return true;
+}
+
+std::optional<std::string> ModularCharacterSpriteManager::resolvePartPath(const std::string& folderName,
+    const std::string& partName) const {
+    // Папки-кандидаты и их приоритет знает манифест, здесь один поиск по ID
+    return AssetManifest::instance().resolve("char." + folderName + "." + partName);
+}
+
+bool ModularCharacterSpriteManager::loadPartImage(const std::string& path, sf::Image& image) const {
+    // С архивом картинка декодируется прямо из отображения в память
+    auto& archive = AssetArchive::instance();
+    if (auto blob = archive.find(path)) {
+        if (image.loadFromMemory(blob->data, blob->size)) {
+            return true;
         }
+        std::cerr << "Failed to decode: " << path << std::endl;
+        return false;
     }
 
-    std::cout << "Loaded " << characterParts[typeIndex].size() << " " << folderName << " parts" << std::endl;
-    return !characterParts[typeIndex].empty();
+    if (archive.owns(path)) return false;
+
+    return image.loadFromFile(path);
 }
 
 bool ModularCharacterSpriteManager::loadCharacterParts() {
-    std::cout << "Starting to load character parts..." << std::endl;
+    std::cout << "Building character parts catalogue..." << std::endl;
+    sf::Clock clock;
 
     bool allLoaded = true;
+    loadToken = std::make_shared<bool>(true);
+    atlas.clear();
+    loadedImageCount = 0;
+    partSources.clear();
+    recolorPalettes.clear();
+    neighbourParts.clear();
+    compositeCache.clear();
+    compositeKey.reset();
+    compositeTexture = nullptr;
+
+    // Тела: одна серая маска на пол, оттенки кожи получаются перекраской.
+    // Без масок пробуем отдельные картинки на каждый цвет
+    if (!addRecolorCategory(PartType::Base, "base", { "male", "female", "other" }, buildPalettes(SKIN_TONES))) {
+        allLoaded &= addPartCategory(PartType::Base, "base", {
+            "male_light", "male_medium", "male_dark",
+            "female_light", "female_medium", "female_dark",
+            "other_light", "other_medium", "other_dark"
+            });
+    }
 
-    // Пробуем загрузить базовые части
-    allLoaded &= loadPartCategory(PartType::Base, "base", {
-        "male_light", "male_medium", "male_dark",
-        "female_light", "female_medium", "female_dark",
-        "other_light", "other_medium", "other_dark"
-        });
-
-    // Если базовые части не загрузились, попробуем упрощенные варианты
+    // Если базовые части не нашлись, попробуем упрощенные варианты
     if (characterParts[static_cast<size_t>(PartType::Base)].empty()) {
         std::cout << "Trying simplified base parts..." << std::endl;
-        allLoaded &= loadPartCategory(PartType::Base, "base", {
+        allLoaded &= addPartCategory(PartType::Base, "base", {
             "male", "female", "body"
             });
     }
 
-    allLoaded &= loadPartCategory(PartType::Hair, "hair", {
-        "short_black", "short_brown", "short_blonde",
-        "long_black", "long_brown", "long_blonde",
-        "curly_black", "curly_brown", "curly_blonde"
-        });
+    // Волосы: маска на прическу, цвета из палитр HAIR_COLORS
+    if (!addRecolorCategory(PartType::Hair, "hair", { "short", "long", "curly" }, buildPalettes(HAIR_COLORS))) {
+        allLoaded &= addPartCategory(PartType::Hair, "hair", {
+            "short_black", "short_brown", "short_blonde",
+            "long_black", "long_brown", "long_blonde",
+            "curly_black", "curly_brown", "curly_blonde"
+            });
+    }
 
     // Упрощенные варианты для волос
     if (characterParts[static_cast<size_t>(PartType::Hair)].empty()) {
-        allLoaded &= loadPartCategory(PartType::Hair, "hair", {
+        allLoaded &= addPartCategory(PartType::Hair, "hair", {
             "hair1", "hair2", "hair3"
             });
     }
 
-    allLoaded &= loadPartCategory(PartType::Eyes, "eyes", {
+    allLoaded &= addPartCategory(PartType::Eyes, "eyes", {
         "blue", "green", "brown", "gray"
         });
 
     if (characterParts[static_cast<size_t>(PartType::Eyes)].empty()) {
-        allLoaded &= loadPartCategory(PartType::Eyes, "eyes", {
+        allLoaded &= addPartCategory(PartType::Eyes, "eyes", {
             "eyes1", "eyes2"
             });
     }
 
-    allLoaded &= loadPartCategory(PartType::Face, "face", {
+    allLoaded &= addPartCategory(PartType::Face, "face", {
         "round", "oval", "square"
         });
 
     if (characterParts[static_cast<size_t>(PartType::Face)].empty()) {
-        allLoaded &= loadPartCategory(PartType::Face, "face", {
+        allLoaded &= addPartCategory(PartType::Face, "face", {
             "face1", "face2"
             });
     }
 
-    partsLoaded = true; // Даже если не все загрузилось, можем показывать что есть
+    partsLoaded = true; // Даже если не все нашлось, можем показывать что есть
     updatePartPositions();
 
-    std::cout << "Character parts loading completed. Success: " << (allLoaded ? "Yes" : "Partial") << std::endl;
+    std::cout << "Character parts catalogue built in " << clock.getElapsedTime().asMilliseconds()
+        << " ms (" << partSources.size() << " images). Success: " << (allLoaded ? "Yes" : "Partial") << std::endl;
     return allLoaded;
 }
 
+void ModularCharacterSpriteManager::requestPart(size_t typeIndex, int index, bool urgent) {
+    if (index < 0 || index >= static_cast<int>(characterParts[typeIndex].size())) return;
+
+    auto& part = characterParts[typeIndex][index];
+    part.lastUsed = ++useCounter;
+    if (part.inAtlas || part.failed) return;
+
+    part.requested = true;
+    auto& source = partSources[part.sourceIndex];
+    if (source.state == PartSource::State::Ready) {
+        // Маска уже в памяти — вариант перекрашивается сразу
+        placePart(part);
+    }
+    else if (source.state == PartSource::State::Unloaded) {
+        startSourceLoad(part.sourceIndex, urgent);
+    }
+}
+
+void ModularCharacterSpriteManager::requestCurrentParts() {
+    for (size_t typeIndex = 0; typeIndex < static_cast<size_t>(PartType::COUNT); ++typeIndex) {
+        requestPart(typeIndex, currentPartIndices[typeIndex], true);
+    }
+}
+
+void ModularCharacterSpriteManager::prefetchNeighbours(const CharacterAppearance& appearance) {
+    // Соседи — внешности, до которых один клик "<" или ">" в любой строке настроек
+    auto current = partIndicesFor(appearance);
+    neighbourParts.clear();
+
+    for (int field = 0; field < APPEARANCE_FIELDS; ++field) {
+        for (int delta : { -1, 1 }) {
+            CharacterAppearance neighbour = appearance;
+            int* values[] = { &neighbour.gender, &neighbour.hairType, &neighbour.hairColor,
+                &neighbour.skinTone, &neighbour.faceType, &neighbour.bodyType };
+            *values[field] = (*values[field] + delta + APPEARANCE_OPTIONS) % APPEARANCE_OPTIONS;
+
+            auto indices = partIndicesFor(neighbour);
+            for (size_t typeIndex = 0; typeIndex < indices.size(); ++typeIndex) {
+                if (indices[typeIndex] >= 0 && indices[typeIndex] != current[typeIndex]) {
+                    neighbourParts.push_back({ typeIndex, indices[typeIndex] });
+                }
+            }
+        }
+    }
+
+    for (const auto& neighbour : neighbourParts) {
+        requestPart(neighbour.first, neighbour.second, false);
+    }
+}
+
+void ModularCharacterSpriteManager::startSourceLoad(int sourceIndex, bool urgent) {
+    auto& source = partSources[sourceIndex];
+    source.state = PartSource::State::Loading;
+
+    std::weak_ptr<bool> token = loadToken;
+    AssetLoader::instance().requestImage({ source.path },
+        [this, token, sourceIndex](std::optional<sf::Image>&& image) {
+            // Каталог пересобран или менеджер уже уничтожен — ответ устарел
+            if (token.expired()) return;
+            onSourceLoaded(sourceIndex, std::move(image));
+        }, urgent);
+}
+
+void ModularCharacterSpriteManager::onSourceLoaded(int sourceIndex, std::optional<sf::Image>&& image) {
+    auto& source = partSources[sourceIndex];
+    // Картинку могли уже загрузить синхронно (бенчмарк)
+    if (source.state == PartSource::State::Ready) return;
+
+    if (!image) {
+        std::cerr << "Failed to load: " << source.path << std::endl;
+        source.state = PartSource::State::Failed;
+        for (auto& parts : characterParts) {
+            for (auto& part : parts) {
+                if (part.sourceIndex == sourceIndex) part.failed = true;
+            }
+        }
+        return;
+    }
+
+    loadedImageCount++;
+    source.image = std::move(image);
+    source.state = PartSource::State::Ready;
+
+    for (auto& parts : characterParts) {
+        for (auto& part : parts) {
+            if (part.sourceIndex == sourceIndex && part.requested && !part.inAtlas) {
+                placePart(part);
+            }
+        }
+    }
+
+    // Отдельной картинке CPU-копия больше не нужна, маска остается для других цветов
+    if (!source.isMask) {
+        source.image.reset();
+        source.state = PartSource::State::Unloaded;
+    }
+
+    enforceMemoryBudget();
+}
+
+void ModularCharacterSpriteManager::placePart(CharacterPart& part) {
+    const auto& source = partSources[part.sourceIndex];
+    part.requested = false;
+
+    std::optional<sf::IntRect> rect;
+    if (part.paletteIndex >= 0) {
+        sf::Clock clock;
+        sf::Image variant = PaletteRecolor::recolor(*source.image, recolorPalettes[part.paletteIndex]);
+        rect = atlas.insert(variant);
+        std::cout << "Recolored part variant in " << clock.getElapsedTime().asMicroseconds()
+            << " us (" << PaletteRecolor::getKernelName() << ")" << std::endl;
+    }
+    else {
+        rect = atlas.insert(*source.image);
+    }
+
+    if (!rect) {
+        std::cerr << "No atlas space for: " << source.path << std::endl;
+        part.failed = true;
+        return;
+    }
+
+    // Атлас и служит кэшем: вариант генерируется один раз, пока его не вытеснит бюджет
+    part.atlasRect = *rect;
+    part.inAtlas = true;
+}
+
+void ModularCharacterSpriteManager::loadPartNow(size_t typeIndex, int index) {
+    if (index < 0 || index >= static_cast<int>(characterParts[typeIndex].size())) return;
+
+    auto& part = characterParts[typeIndex][index];
+    part.lastUsed = ++useCounter;
+    if (part.inAtlas || part.failed) return;
+
+    part.requested = true;
+    auto& source = partSources[part.sourceIndex];
+    if (source.state == PartSource::State::Ready) {
+        placePart(part);
+        return;
+    }
+
+    sf::Image image;
+    if (loadPartImage(source.path, image)) {
+        onSourceLoaded(part.sourceIndex, std::move(image));
+    }
+    else {
+        onSourceLoaded(part.sourceIndex, std::nullopt);
+    }
+}
+
+bool ModularCharacterSpriteManager::areCurrentPartsReady() const {
+    for (size_t typeIndex = 0; typeIndex < static_cast<size_t>(PartType::COUNT); ++typeIndex) {
+        int currentIndex = currentPartIndices[typeIndex];
+        if (currentIndex >= 0 && currentIndex < static_cast<int>(characterParts[typeIndex].size())) {
+            const auto& part = characterParts[typeIndex][currentIndex];
+            if (!part.inAtlas && !part.failed) return false;
+        }
+    }
+    return true;
+}
+
+std::size_t ModularCharacterSpriteManager::getResidentBytes() const {
+    std::size_t bytes = atlas.getUsedBytes();
+    for (const auto& source : partSources) {
+        if (source.image) {
+            auto size = source.image->getSize();
+            bytes += static_cast<std::size_t>(size.x) * size.y * 4;
+        }
+    }
+    return bytes;
+}
+
+void ModularCharacterSpriteManager::enforceMemoryBudget() {
+    std::size_t resident = getResidentBytes();
+    if (resident <= PART_MEMORY_BUDGET) return;
+
+    // Текущие части и соседи не вытесняются
+    auto isProtected = [this](size_t typeIndex, int index) {
+        if (currentPartIndices[typeIndex] == index) return true;
+        for (const auto& neighbour : neighbourParts) {
+            if (neighbour.first == typeIndex && neighbour.second == index) return true;
+        }
+        return false;
+    };
+
+    std::vector<std::pair<size_t, int>> candidates;
+    for (size_t typeIndex = 0; typeIndex < static_cast<size_t>(PartType::COUNT); ++typeIndex) {
+        for (int index = 0; index < static_cast<int>(characterParts[typeIndex].size()); ++index) {
+            if (characterParts[typeIndex][index].inAtlas && !isProtected(typeIndex, index)) {
+                candidates.push_back({ typeIndex, index });
+            }
+        }
+    }
+
+    // Самые давно показанные уходят первыми
+    std::sort(candidates.begin(), candidates.end(), [this](const auto& a, const auto& b) {
+        return characterParts[a.first][a.second].lastUsed < characterParts[b.first][b.second].lastUsed;
+    });
+
+    std::size_t evicted = 0;
+    for (const auto& candidate : candidates) {
+        if (resident <= PART_MEMORY_BUDGET) break;
+
+        auto& part = characterParts[candidate.first][candidate.second];
+        part.inAtlas = false;
+        resident -= static_cast<std::size_t>(part.atlasRect.size.x) * part.atlasRect.size.y * 4;
+        evicted++;
+    }
+
+    // Маски, из которых сейчас ничего не нужно, тоже освобождаем
+    if (resident > PART_MEMORY_BUDGET) {
+        std::vector<bool> sourcesInUse(partSources.size(), false);
+        for (size_t typeIndex = 0; typeIndex < static_cast<size_t>(PartType::COUNT); ++typeIndex) {
+            for (int index = 0; index < static_cast<int>(characterParts[typeIndex].size()); ++index) {
+                const auto& part = characterParts[typeIndex][index];
+                if (part.requested || isProtected(typeIndex, index)) sourcesInUse[part.sourceIndex] = true;
+            }
+        }
+
+        for (size_t i = 0; i < partSources.size() && resident > PART_MEMORY_BUDGET; ++i) {
+            auto& source = partSources[i];
+            if (!source.image || sourcesInUse[i]) continue;
+
+            auto size = source.image->getSize();
+            resident -= static_cast<std::size_t>(size.x) * size.y * 4;
+            source.image.reset();
+            source.state = PartSource::State::Unloaded;
+        }
+    }
+
+    if (evicted == 0) return;
+
+    // Перепаковываем атлас из оставшихся частей, место вытесненных освобождается
+    std::vector<CharacterPart*> kept;
+    std::vector<sf::IntRect> keptRects;
+    for (auto& parts : characterParts) {
+        for (auto& part : parts) {
+            if (part.inAtlas) {
+                kept.push_back(&part);
+                keptRects.push_back(part.atlasRect);
+            }
+        }
+    }
+
+    // Не удалось — атлас прежний: оставшиеся части на старых местах, место вытесненных просто не освободилось
+    if (auto newRects = atlas.compact(keptRects)) {
+        for (size_t i = 0; i < kept.size(); ++i) {
+            kept[i]->atlasRect = (*newRects)[i];
+        }
+    }
+    else {
+        std::cerr << "Character atlas compaction failed, keeping the old layout" << std::endl;
+    }
+
+    std::cout << "Evicted " << evicted << " character parts, resident: " << getResidentBytes() / 1024
+        << " KB of " << PART_MEMORY_BUDGET / 1024 << " KB" << std::endl;
+}
+
 void ModularCharacterSpriteManager::setPartIndex(PartType partType, int index) {
     size_t typeIndex = static_cast<size_t>(partType);
     if (index >= 0 && index < static_cast<int>(characterParts[typeIndex].size())) {
         currentPartIndices[typeIndex] = index;
+        // Ручной выбор части не соответствует ни одной внешности — рисуем слои напрямую
+        compositeKey.reset();
+        compositeTexture = nullptr;
+        requestPart(typeIndex, index, true);
         updatePartPositions();
         std::cout << "Set part " << static_cast<int>(partType) << " to index " << index << std::endl;
     }
@@ -185,64 +533,106 @@ int ModularCharacterSpriteManager::getCurrentPartIndex(PartType partType) const
 }
 
 void ModularCharacterSpriteManager::updatePartPositions() {
-    for (size_t typeIndex = 0; typeIndex < static_cast<size_t>(PartType::COUNT); ++typeIndex) {
-        if (currentPartIndices[typeIndex] < static_cast<int>(characterParts[typeIndex].size())) {
-            auto& part = characterParts[typeIndex][currentPartIndices[typeIndex]];
-            part.setPosition(basePosition);
-            part.setScale({ baseScale, baseScale });
-        }
-    }
-
-    // Обновляем fallback sprite
+    // Части позиционируются при сборке вершин в render(), здесь остается только fallback
     if (fallbackLoaded) {
         fallbackSprite.setPosition(basePosition);
         fallbackSprite.setScale({ baseScale, baseScale });
     }
 }
 
-void ModularCharacterSpriteManager::updateCharacterSprite(const CharacterAppearance& appearance) {
-    if (!partsLoaded) {
-        std::cout << "Parts not loaded, cannot update character sprite" << std::endl;
-        return;
-    }
+std::array<int, static_cast<size_t>(PartType::COUNT)> ModularCharacterSpriteManager::partIndicesFor(
+    const CharacterAppearance& appearance) const {
+    std::array<int, static_cast<size_t>(PartType::COUNT)> indices;
 
     // Безопасное определение индексов с проверкой границ
-    int baseIndex = std::min(appearance.gender * 3 + appearance.skinTone,
+    indices[static_cast<size_t>(PartType::Base)] = std::min(appearance.gender * 3 + appearance.skinTone,
         getPartCount(PartType::Base) - 1);
-    if (baseIndex >= 0) setPartIndex(PartType::Base, baseIndex);
-
-    int hairIndex = std::min(appearance.hairType * 3 + appearance.hairColor,
+    indices[static_cast<size_t>(PartType::Hair)] = std::min(appearance.hairType * 3 + appearance.hairColor,
         getPartCount(PartType::Hair) - 1);
-    if (hairIndex >= 0) setPartIndex(PartType::Hair, hairIndex);
+    indices[static_cast<size_t>(PartType::Eyes)] = std::min(0, getPartCount(PartType::Eyes) - 1);
+    indices[static_cast<size_t>(PartType::Face)] = std::min(appearance.faceType, getPartCount(PartType::Face) - 1);
+    return indices;
+}
 
-    int eyeIndex = std::min(0, getPartCount(PartType::Eyes) - 1);
-    if (eyeIndex >= 0) setPartIndex(PartType::Eyes, eyeIndex);
+void ModularCharacterSpriteManager::selectParts(const CharacterAppearance& appearance) {
+    auto indices = partIndicesFor(appearance);
+    for (size_t typeIndex = 0; typeIndex < indices.size(); ++typeIndex) {
+        if (indices[typeIndex] >= 0) currentPartIndices[typeIndex] = indices[typeIndex];
+    }
+}
 
-    int faceIndex = std::min(appearance.faceType, getPartCount(PartType::Face) - 1);
-    if (faceIndex >= 0) setPartIndex(PartType::Face, faceIndex);
+void ModularCharacterSpriteManager::refreshComposite() {
+    // Запеченная картинка есть — части для нее не нужны; иначе срочно грузим текущие
+    compositeTexture = compositeKey ? compositeCache.find(*compositeKey) : nullptr;
+    if (!compositeTexture) {
+        requestCurrentParts();
+    }
+}
+
+void ModularCharacterSpriteManager::updateCharacterSprite(const CharacterAppearance& appearance) {
+    if (!partsLoaded) {
+        std::cout << "Parts not loaded, cannot update character sprite" << std::endl;
+        return;
+    }
+
+    selectParts(appearance);
+    compositeKey = appearance.hash();
+    refreshComposite();
+    prefetchNeighbours(appearance);
+    enforceMemoryBudget();
 
     std::cout << "Updated character sprite with indices: "
-        << baseIndex << ", " << hairIndex << ", " << eyeIndex << ", " << faceIndex << std::endl;
+        << currentPartIndices[0] << ", " << currentPartIndices[1] << ", "
+        << currentPartIndices[2] << ", " << currentPartIndices[3] << std::endl;
 }
 
-void ModularCharacterSpriteManager::render(sf::RenderWindow& window, sf::Vector2f position, float scale) {
-    // Адаптивное позиционирование для разных разрешений
-    auto windowSize = window.getSize();
-    float scaleX = static_cast<float>(windowSize.x) / 1280.0f;
-    float scaleY = static_cast<float>(windowSize.y) / 720.0f;
-    float adaptiveScale = std::min(scaleX, scaleY) * scale;
+void ModularCharacterSpriteManager::render(sf::RenderTarget& target, sf::Vector2f position, float scale) {
+    // Позиция и масштаб в координатах виртуального холста 1280x720; под окно масштабирует вид
+    if (basePosition != position || baseScale != scale) {
+        basePosition = position;
+        baseScale = scale;
+        updatePartPositions();
+    }
 
-    // Адаптивная позиция
-    sf::Vector2f adaptivePosition = {
-        position.x * scaleX,
-        position.y * scaleY
-    };
+    // Внешность не менялась — берем запеченную картинку; запекаем, только когда все слои загружены
+    bool partsReady = areCurrentPartsReady();
+    if (compositeKey && !compositeTexture && partsReady) {
+        compositeTexture = bakeComposite(*compositeKey);
+        if (!compositeTexture) {
+            compositeKey.reset();
+        }
+    }
 
-    basePosition = adaptivePosition;
-    baseScale = adaptiveScale;
-    updatePartPositions();
+    if (compositeTexture) {
+        sf::Sprite composite(*compositeTexture);
+        composite.setPosition(basePosition);
+        composite.setScale({ baseScale, baseScale });
+        target.draw(composite, sf::RenderStates(PREMULTIPLIED_ALPHA));
+        lastDrawCalls = 1;
+        return;
+    }
 
-    bool anyPartRendered = false;
+    buildPartVertices(basePosition, baseScale);
+
+    lastDrawCalls = 0;
+    if (partVertices.getVertexCount() > 0) {
+        target.draw(partVertices, sf::RenderStates(&atlas.getTexture()));
+        lastDrawCalls = 1;
+    }
+    // Если ничего не отрендерилось и ждать нечего, показываем fallback
+    else if (partsReady && fallbackLoaded) {
+        std::cout << "No parts rendered, showing fallback at position: "
+            << basePosition.x << ", " << basePosition.y << std::endl;
+        target.draw(fallbackSprite);
+        lastDrawCalls = 1;
+    }
+}
+
+void ModularCharacterSpriteManager::buildPartVertices(sf::Vector2f origin, float scale) {
+    // Новые части попадают в GPU одной загрузкой атласа
+    if (atlas.isDirty()) {
+        atlas.upload();
+    }
 
     // Рендерим части в правильном порядке
     std::array<PartType, 4> renderOrder = {
@@ -252,39 +642,75 @@ void ModularCharacterSpriteManager::render(sf::RenderWindow& window, sf::Vector2
         PartType::Hair
     };
 
+    // Слои собираются в один массив треугольников поверх атласа
+    partVertices.clear();
     for (PartType partType : renderOrder) {
         size_t typeIndex = static_cast<size_t>(partType);
         int currentIndex = currentPartIndices[typeIndex];
 
         if (currentIndex >= 0 && currentIndex < static_cast<int>(characterParts[typeIndex].size())) {
             const auto& part = characterParts[typeIndex][currentIndex];
-            if (part.isLoaded) {
-                window.draw(part.sprite);
-                anyPartRendered = true;
+            if (part.inAtlas) {
+                appendPartQuad(part, origin, scale);
             }
         }
     }
+}
 
-    // Если ничего не отрендерилось, показываем fallback
-    if (!anyPartRendered && fallbackLoaded) {
-        std::cout << "No parts rendered, showing fallback at position: "
-            << adaptivePosition.x << ", " << adaptivePosition.y << std::endl;
-        window.draw(fallbackSprite);
-    }
+const sf::Texture* ModularCharacterSpriteManager::bakeComposite(std::uint64_t key) {
+    // Запекаем в масштабе 1: размер и позиция на экране задаются спрайтом при отрисовке
+    buildPartVertices({ 0, 0 }, 1.0f);
+    if (partVertices.getVertexCount() == 0) return nullptr;
+
+    sf::FloatRect bounds = partVertices.getBounds();
+    sf::Vector2u size(
+        static_cast<unsigned int>(std::ceil(bounds.position.x + bounds.size.x)),
+        static_cast<unsigned int>(std::ceil(bounds.position.y + bounds.size.y)));
+
+    sf::RenderTexture* target = compositeCache.acquire(key, size);
+    if (!target) return nullptr;
+
+    target->draw(partVertices, sf::RenderStates(&atlas.getTexture()));
+    target->display();
+    return &target->getTexture();
+}
+
+void ModularCharacterSpriteManager::appendPartQuad(const CharacterPart& part, sf::Vector2f origin, float scale) {
+    sf::Vector2f texPos(part.atlasRect.position);
+    sf::Vector2f texSize(part.atlasRect.size);
+
+    sf::Vector2f topLeft = origin;
+    sf::Vector2f bottomRight = origin + texSize * scale;
+
+    sf::Vertex quad[4];
+    quad[0] = { topLeft, sf::Color::White, texPos };
+    quad[1] = { { bottomRight.x, topLeft.y }, sf::Color::White, { texPos.x + texSize.x, texPos.y } };
+    quad[2] = { bottomRight, sf::Color::White, texPos + texSize };
+    quad[3] = { { topLeft.x, bottomRight.y }, sf::Color::White, { texPos.x, texPos.y + texSize.y } };
+
+    partVertices.append(quad[0]);
+    partVertices.append(quad[1]);
+    partVertices.append(quad[2]);
+    partVertices.append(quad[0]);
+    partVertices.append(quad[2]);
+    partVertices.append(quad[3]);
 }
 
 void ModularCharacterSpriteManager::randomizeAppearance() {
     if (!partsLoaded) return;
 
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+    auto& rng = Rng::instance().stream(RngStreamId::Appearance);
 
     for (size_t i = 0; i < static_cast<size_t>(PartType::COUNT); ++i) {
         if (!characterParts[i].empty()) {
-            int randomIndex = std::rand() % characterParts[i].size();
+            int randomIndex = rng.nextInt(static_cast<int>(characterParts[i].size()));
             currentPartIndices[i] = randomIndex;
         }
     }
 
+    compositeKey.reset();
+    compositeTexture = nullptr;
+    requestCurrentParts();
     updatePartPositions();
     std::cout << "Randomized appearance" << std::endl;
 }
@@ -324,175 +750,122 @@ void ModularCharacterSpriteManager::printDebugInfo() const {
         std::cout << partNames[i] << ": " << characterParts[i].size()
             << " parts, current index: " << currentPartIndices[i] << std::endl;
     }
-    std::cout << "=================================" << std::endl;
-}
-
-// AppearanceButton Implementation (без изменений)
-AppearanceButton::AppearanceButton(const sf::Font& font, const std::string& buttonText,
-    sf::Vector2f position, sf::Vector2f size) {
-    shape.setSize(size);
-    shape.setPosition(position);
-    shape.setFillColor(sf::Color(50, 50, 50, 180));
-    shape.setOutlineColor(sf::Color(139, 0, 0));
-    shape.setOutlineThickness(2.0f);
-
-    text = std::make_unique<sf::Text>(font);
-    text->setString(buttonText);
-    text->setFillColor(sf::Color(139, 0, 0));
-    text->setCharacterSize(20);
-
-    sf::FloatRect textBounds = text->getGlobalBounds();
-    text->setPosition({
-        position.x + (size.x - textBounds.size.x) / 2.0f,
-        position.y + (size.y - textBounds.size.y) / 2.0f
-        });
-}
-
-bool AppearanceButton::contains(sf::Vector2f point) const {
-    return shape.getGlobalBounds().contains(point);
-}
-
-void AppearanceButton::setHovered(bool hovered) {
-    isHovered = hovered;
-    if (hovered) {
-        shape.setFillColor(sf::Color(80, 80, 80, 200));
-        shape.setOutlineColor(sf::Color(200, 50, 50));
-    }
-    else {
-        shape.setFillColor(sf::Color(50, 50, 50, 180));
-        shape.setOutlineColor(sf::Color(139, 0, 0));
-    }
-}
-
-void AppearanceButton::handleClick() {
-    if (onClick) {
-        onClick();
-    }
-}
 
-void AppearanceButton::render(sf::RenderWindow& window) {
-    window.draw(shape);
-    if (text) {
-        window.draw(*text);
+    std::size_t variantCount = 0;
+    std::size_t residentCount = 0;
+    for (const auto& parts : characterParts) {
+        variantCount += parts.size();
+        for (const auto& part : parts) {
+            if (part.inAtlas) residentCount++;
+        }
     }
-}
 
-// AppearanceConfigLine Implementation (адаптивный)
-AppearanceConfigLine::AppearanceConfigLine(const sf::Font& font, AppearanceType appearanceType,
-    const std::string& name, const std::vector<std::string>& availableOptions,
-    sf::Vector2f position, float scale)
-    : type(appearanceType), options(availableOptions) {
-
-    nameText = std::make_unique<sf::Text>(font);
-    nameText->setString(name);
-    nameText->setFillColor(sf::Color(139, 0, 0));
-    nameText->setCharacterSize(static_cast<unsigned int>(24 * scale));
-    nameText->setPosition(position);
-
-    valueText = std::make_unique<sf::Text>(font);
-    valueText->setFillColor(sf::Color(200, 200, 200));
-    valueText->setCharacterSize(static_cast<unsigned int>(24 * scale));
-    valueText->setPosition({ position.x + 250 * scale, position.y });
-
-    sf::Vector2f buttonSize(35 * scale, 30 * scale);
-
-    prevButton = std::make_unique<AppearanceButton>(
-        font, "<",
-        sf::Vector2f(position.x + 400 * scale, position.y),
-        buttonSize
-    );
-
-    nextButton = std::make_unique<AppearanceButton>(
-        font, ">",
-        sf::Vector2f(position.x + 440 * scale, position.y),
-        buttonSize
-    );
-
-    prevButton->setOnClick([this]() { previousOption(); });
-    nextButton->setOnClick([this]() { nextOption(); });
-
-    updateValueDisplay();
+    std::cout << "Images decoded: " << loadedImageCount << " of " << partSources.size() << " for "
+        << variantCount << " part variants, recolor kernel: " << PaletteRecolor::getKernelName() << std::endl;
+    std::cout << "Resident parts: " << residentCount << ", memory: " << getResidentBytes() / 1024
+        << " KB of " << PART_MEMORY_BUDGET / 1024 << " KB budget" << std::endl;
+
+    // Сравнение с прежней схемой "одна текстура на вариант, один draw на слой"
+    auto atlasSize = atlas.getTexture().getSize();
+    std::cout << "Texture memory before: " << residentCount << " textures, "
+        << atlas.getUsedBytes() / 1024 << " KB" << std::endl;
+    std::cout << "Texture memory after: 1 atlas " << atlasSize.x << "x" << atlasSize.y << ", "
+        << atlas.getTextureBytes() / 1024 << " KB" << std::endl;
+    std::cout << "Draw calls per frame: before " << partVertices.getVertexCount() / 6
+        << " (one per layer), after " << lastDrawCalls << std::endl;
+
+    const auto& stats = compositeCache.getStats();
+    std::cout << "Composite cache: " << compositeCache.getSize() << "/" << compositeCache.getCapacity()
+        << " entries, " << compositeCache.getTextureBytes() / 1024 << " KB, hits: " << stats.hits
+        << ", misses: " << stats.misses << ", evictions: " << stats.evictions << std::endl;
+    std::cout << "=================================" << std::endl;
 }
 
-void AppearanceConfigLine::setValue(int value) {
-    if (value >= 0 && value < static_cast<int>(options.size())) {
-        currentIndex = value;
-        updateValueDisplay();
-        if (onValueChanged) {
-            onValueChanged(currentIndex);
-        }
+void ModularCharacterSpriteManager::runCompositeBenchmark() {
+    if (!partsLoaded) {
+        std::cout << "Parts not loaded, composite benchmark skipped" << std::endl;
+        return;
     }
-}
 
-void AppearanceConfigLine::updateValueDisplay() {
-    if (!options.empty() && currentIndex >= 0 && currentIndex < static_cast<int>(options.size())) {
-        if (valueText) {
-            valueText->setString(options[currentIndex]);
+    auto savedIndices = currentPartIndices;
+    auto savedKey = compositeKey;
+    auto savedNeighbours = neighbourParts;
+    neighbourParts.clear();
+
+    // Все комбинации: каждое из 6 полей принимает 3 значения
+    std::vector<CharacterAppearance> combinations;
+    int total = 1;
+    for (int i = 0; i < APPEARANCE_FIELDS; ++i) total *= APPEARANCE_OPTIONS;
+    combinations.reserve(total);
+    for (int i = 0; i < total; ++i) {
+        int value = i;
+        CharacterAppearance appearance;
+        for (int* field : { &appearance.gender, &appearance.hairType, &appearance.hairColor,
+            &appearance.skinTone, &appearance.faceType, &appearance.bodyType }) {
+            *field = value % APPEARANCE_OPTIONS;
+            value /= APPEARANCE_OPTIONS;
         }
+        combinations.push_back(appearance);
     }
-}
 
-void AppearanceConfigLine::previousOption() {
-    if (currentIndex > 0) {
-        currentIndex--;
-    }
-    else {
-        currentIndex = static_cast<int>(options.size()) - 1;
-    }
-    updateValueDisplay();
-    if (onValueChanged) {
-        onValueChanged(currentIndex);
-    }
-}
+    // Промах кэша догружает нужные части синхронно, чтобы запекание видело все слои
+    auto show = [this](const CharacterAppearance& appearance) {
+        selectParts(appearance);
+        std::uint64_t key = appearance.hash();
+        if (compositeCache.find(key)) return true;
 
-void AppearanceConfigLine::nextOption() {
-    if (currentIndex < static_cast<int>(options.size()) - 1) {
-        currentIndex++;
-    }
-    else {
-        currentIndex = 0;
-    }
-    updateValueDisplay();
-    if (onValueChanged) {
-        onValueChanged(currentIndex);
-    }
-}
+        for (size_t typeIndex = 0; typeIndex < static_cast<size_t>(PartType::COUNT); ++typeIndex) {
+            loadPartNow(typeIndex, currentPartIndices[typeIndex]);
+        }
+        return bakeComposite(key) != nullptr;
+    };
 
-void AppearanceConfigLine::updateHover(sf::Vector2f mousePos) {
-    if (prevButton) prevButton->setHovered(prevButton->contains(mousePos));
-    if (nextButton) nextButton->setHovered(nextButton->contains(mousePos));
-}
+    compositeCache.clear();
+    compositeCache.resetStats();
 
-void AppearanceConfigLine::handleClick(sf::Vector2f mousePos) {
-    if (prevButton && prevButton->contains(mousePos)) {
-        prevButton->handleClick();
-    }
-    if (nextButton && nextButton->contains(mousePos)) {
-        nextButton->handleClick();
+    // Первый проход: каждая комбинация встречается впервые и запекается
+    sf::Clock clock;
+    for (const auto& appearance : combinations) {
+        show(appearance);
     }
-}
-
-void AppearanceConfigLine::render(sf::RenderWindow& window) {
-    if (nameText) window.draw(*nameText);
-    if (valueText) window.draw(*valueText);
-    if (prevButton) prevButton->render(window);
-    if (nextButton) nextButton->render(window);
-}
-
-void AppearanceConfigLine::updatePositions(sf::Vector2f position, float scale) {
-    if (nameText) {
-        nameText->setPosition(position);
-        nameText->setCharacterSize(static_cast<unsigned int>(24 * scale));
+    sf::Time coldTime = clock.restart();
+    auto coldStats = compositeCache.getStats();
+    compositeCache.resetStats();
+
+    // Второй проход: листаем туда-обратно последние комбинации, которые еще лежат в кэше
+    const int rounds = 100;
+    std::size_t recent = std::min(compositeCache.getCapacity(), combinations.size());
+    std::size_t flips = 0;
+    clock.restart();
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = combinations.size() - recent; i < combinations.size(); ++i) {
+            show(combinations[i]);
+            flips++;
+        }
     }
+    sf::Time warmTime = clock.getElapsedTime();
+    const auto& warmStats = compositeCache.getStats();
+
+    std::cout << "=== Composite Cache Benchmark ===" << std::endl;
+    std::cout << "Combinations: " << combinations.size() << ", cache capacity: "
+        << compositeCache.getCapacity() << std::endl;
+    std::cout << "First pass (bake, incl. part loads): " << coldTime.asMilliseconds() << " ms total, "
+        << coldTime.asMicroseconds() / static_cast<std::int64_t>(combinations.size()) << " us per combination, misses: "
+        << coldStats.misses << ", evictions: " << coldStats.evictions << std::endl;
+    std::cout << "Flip back (cached): " << flips << " flips, "
+        << warmTime.asMicroseconds() / static_cast<std::int64_t>(std::max<std::size_t>(1, flips))
+        << " us per flip, hits: " << warmStats.hits << ", misses: " << warmStats.misses << std::endl;
+    std::cout << "=================================" << std::endl;
 
-    if (valueText) {
-        valueText->setPosition({ position.x + 250 * scale, position.y });
-        valueText->setCharacterSize(static_cast<unsigned int>(24 * scale));
-    }
+    currentPartIndices = savedIndices;
+    compositeKey = savedKey;
+    neighbourParts = savedNeighbours;
+    refreshComposite();
 }
 
 // Исправленная AppearanceScene
-AppearanceScene::AppearanceScene(GameConfig& config) : config(config) {
+AppearanceScene::AppearanceScene(GameConfig& config, SceneParams choices)
+    : config(config), choices(std::move(choices)) {
     std::cout << "Initializing AppearanceScene..." << std::endl;
 
     loadResources();
@@ -514,31 +887,13 @@ AppearanceScene::AppearanceScene(GameConfig& config) : config(config) {
 }
 
 void AppearanceScene::loadResources() {
-    std::vector<std::string> fontPaths = {
-        "assets/fonts/digital-7 (italic).ttf",
-        "assets/fonts/arial.ttf",
-        "C:\\Windows\\Fonts\\arial.ttf"
-    };
-
-    bool fontLoaded = false;
-    for (const auto& path : fontPaths) {
-        if (font.openFromFile(path)) {
-            fontLoaded = true;
-            std::cout << "Font loaded from: " << path << std::endl;
-            break;
-        }
-    }
-
-    if (!fontLoaded) {
-        std::cerr << "Warning: Could not load font file." << std::endl;
-    }
+    auto& cache = ResourceCache::instance();
+    font = cache.getSdfFont("font.ui");
 
-    if (!backgroundTexture.loadFromFile("assets/textures/menu.png")) {
+    backgroundTexture = cache.getTexture("tex.menu");
+    if (backgroundTexture->getSize().x == 0) {
         std::cerr << "Failed to load background texture." << std::endl;
     }
-    else {
-        backgroundSprite = sf::Sprite(backgroundTexture);
-    }
 }
 
 void AppearanceScene::initializeAppearanceConfigs() {
@@ -553,19 +908,19 @@ void AppearanceScene::initializeAppearanceConfigs() {
 }
 
 void AppearanceScene::initializeUI() {
-    titleText = std::make_unique<sf::Text>(font);
+    titleText = std::make_unique<SdfText>(font);
     titleText->setString("CHARACTER APPEARANCE");
     titleText->setFillColor(sf::Color(139, 0, 0));
     titleText->setCharacterSize(48);
 
-    randomizeButton = std::make_unique<AppearanceButton>(
+    randomizeButton = std::make_unique<UiButton>(
         font, "RANDOMIZE",
         sf::Vector2f(100, 500),
         sf::Vector2f(120, 40)
     );
     randomizeButton->setOnClick([this]() { randomizeAppearance(); });
 
-    confirmButton = std::make_unique<AppearanceButton>(
+    confirmButton = std::make_unique<UiButton>(
         font, "CONFIRM",
         sf::Vector2f(250, 500),
         sf::Vector2f(120, 40)
@@ -577,12 +932,10 @@ void AppearanceScene::setupConfigLines() {
     configLines.clear();
 
     for (size_t i = 0; i < appearanceConfigs.size(); ++i) {
-        auto line = std::make_unique<AppearanceConfigLine>(
+        auto line = std::make_unique<UiSpinner>(
             font,
-            static_cast<AppearanceType>(i),
             appearanceConfigs[i].name,
-            appearanceConfigs[i].options,
-            sf::Vector2f(100, 150 + i * 50)
+            appearanceConfigs[i].options
         );
 
         AppearanceType type = static_cast<AppearanceType>(i);
@@ -604,35 +957,25 @@ void AppearanceScene::setupConfigLines() {
 }
 
 void AppearanceScene::update(float deltaTime, sf::RenderWindow& window) {
-    updatePositions(window);
-
-    sf::Vector2i pixelPos = sf::Mouse::getPosition(window);
-    sf::Vector2f mousePos = window.mapPixelToCoords(pixelPos);
-
-    updateHoverStates(mousePos);
+    // Наведение обновляется по MouseMoved, опрашивать мышь каждый кадр не нужно
     glitchRenderer.update(deltaTime);
 }
 
-void AppearanceScene::updatePositions(sf::RenderWindow& window) {
-    auto windowSize = window.getSize();
-    float scaleX = static_cast<float>(windowSize.x) / 1280.0f;
-    float scaleY = static_cast<float>(windowSize.y) / 720.0f;
-    float scale = std::min(scaleX, scaleY);
-
+void AppearanceScene::layout(sf::RenderWindow& window) {
+    // Координаты холста 1280x720: вид сам растягивает их под окно, пересчет только при ресайзе
     if (titleText) {
-        titleText->setCharacterSize(static_cast<unsigned int>(48 * scale));
-        titleText->setPosition({ 100 * scaleX, 50 * scaleY });
-    }
-
-    if (backgroundSprite.has_value()) {
-        backgroundSprite->setScale({ scaleX, scaleY });
+        titleText->setCharacterSize(48);
+        titleText->setPosition({ 100.f, 50.f });
     }
 
-    // Обновляем позиции элементов интерфейса адаптивно
     for (size_t i = 0; i < configLines.size(); ++i) {
-        sf::Vector2f newPos(100 * scaleX, (150 + i * 50) * scaleY);
-        configLines[i]->updatePositions(newPos, scale);
+        sf::Vector2f newPos(100.f, 150.f + i * 50.f);
+        configLines[i]->setPosition(newPos);
     }
+
+    // Виджеты сдвинулись под неподвижным курсором — проверяем наведение один раз
+    auto pointer = Input::instance().getSnapshot().getPointer(window);
+    updateHoverStates(pointer.value_or(sf::Vector2f(-1.f, -1.f)));
 }
 
 void AppearanceScene::updateHoverStates(sf::Vector2f mousePos) {
@@ -644,48 +987,63 @@ void AppearanceScene::updateHoverStates(sf::Vector2f mousePos) {
     if (confirmButton) confirmButton->setHovered(confirmButton->contains(mousePos));
 }
 
-void AppearanceScene::render(sf::RenderWindow& window) {
-    if (backgroundSprite.has_value()) {
-        window.draw(backgroundSprite.value());
-    }
-    glitchRenderer.renderBackground(window, backgroundTexture);
+void AppearanceScene::render(sf::RenderTarget& target) {
+    glitchRenderer.renderBackground(target, *backgroundTexture);
 
+    auto& queue = RenderQueue::instance();
     if (titleText) {
-        window.draw(*titleText);
+        queue.submit(*titleText, RenderQueue::LAYER_TEXT);
     }
 
     for (auto& line : configLines) {
-        line->render(window);
+        line->render(queue);
     }
 
-    // ИСПОЛЬЗУЕМ modularSpriteManager вместо spriteManager
-    modularSpriteManager.render(window, { 600, 200 }, 2.0f);
+    if (randomizeButton) randomizeButton->render(queue);
+    if (confirmButton) confirmButton->render(queue);
+    queue.flush(target);
 
-    if (randomizeButton) randomizeButton->render(window);
-    if (confirmButton) confirmButton->render(window);
+    // ИСПОЛЬЗУЕМ modularSpriteManager вместо spriteManager; персонаж рисуется своим пакетом атласа
+    modularSpriteManager.render(target, { 600, 200 }, 2.0f);
 
-    glitchRenderer.renderGlitchLines(window, 10);
+    glitchRenderer.renderGlitchLines(target, 10);
+    glitchRenderer.flushOverlay(target);
     glitchRenderer.setBackgroundDarkening(true, 0.2f);
 }
 
 void AppearanceScene::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
-    if (const auto* mouseEvent = event.getIf<sf::Event::MouseButtonPressed>()) {
-        sf::Vector2i pixelPos = sf::Mouse::getPosition(window);
-        sf::Vector2f mousePos = window.mapPixelToCoords(pixelPos);
-        handleMouseClick(mousePos);
+    const std::optional<Action> action = Input::instance().getAction(event);
+
+    if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+        updateHoverStates(window.mapPixelToCoords(moved->position));
+    }
+    else if (event.is<sf::Event::MouseLeft>()) {
+        // Точка вне холста снимает подсветку со всех виджетов
+        updateHoverStates({ -1.f, -1.f });
+    }
+    else if (const auto* mouseEvent = event.getIf<sf::Event::MouseButtonPressed>(); mouseEvent && action == Action::Select) {
+        handleMouseClick(window.mapPixelToCoords(mouseEvent->position));
     }
 
+    // Отладочные клавиши не входят в карту действий
     if (const auto* keyEvent = event.getIf<sf::Event::KeyPressed>()) {
-        if (keyEvent->scancode == sf::Keyboard::Scancode::Enter) {
-            confirmSelection();
-        }
-        if (keyEvent->scancode == sf::Keyboard::Scancode::R) {
-            randomizeAppearance();
-        }
         if (keyEvent->scancode == sf::Keyboard::Scancode::D) {
             // Отладочная информация по нажатию D
             modularSpriteManager.printDebugInfo();
         }
+        if (keyEvent->scancode == sf::Keyboard::Scancode::B) {
+            // Бенчмарк кэша внешности по нажатию B
+            modularSpriteManager.runCompositeBenchmark();
+        }
+    }
+}
+
+void AppearanceScene::handleInput(const InputSnapshot& input) {
+    if (input.wasPressed(Action::Confirm)) {
+        confirmSelection();
+    }
+    else if (input.wasPressed(Action::Randomize)) {
+        randomizeAppearance();
     }
 }
 
@@ -694,13 +1052,8 @@ void AppearanceScene::handleMouseClick(sf::Vector2f mousePos) {
         line->handleClick(mousePos);
     }
 
-    if (randomizeButton && randomizeButton->contains(mousePos)) {
-        randomizeButton->handleClick();
-    }
-
-    if (confirmButton && confirmButton->contains(mousePos)) {
-        confirmButton->handleClick();
-    }
+    if (randomizeButton) randomizeButton->click(mousePos);
+    if (confirmButton) confirmButton->click(mousePos);
 }
 
 void AppearanceScene::onAppearanceValueChanged(AppearanceType type, int value) {
@@ -748,12 +1101,17 @@ void AppearanceScene::randomizeAppearance() {
 
 void AppearanceScene::confirmSelection() {
     std::cout << "Character appearance confirmed!" << std::endl;
+    for (const char* key : { "save", "origin", "specialization" }) {
+        auto it = choices.find(key);
+        std::cout << key << ": " << (it != choices.end() ? it->second : "-") << std::endl;
+    }
     std::cout << "Gender: " << characterData.gender << std::endl;
     std::cout << "Hair: " << characterData.hairType << ", Color: " << characterData.hairColor << std::endl;
     std::cout << "Skin: " << characterData.skinTone << ", Face: " << characterData.faceType << std::endl;
     std::cout << "Body: " << characterData.bodyType << std::endl;
 
-    finished = true;
+    // Создание персонажа закончено — возвращаемся в меню, которое его открыло
+    requestTransition(SceneTransition::pop());
 }
 
 void AppearanceScene::updateCharacterDisplay() {
@@ -766,7 +1124,7 @@ void CharacterSpriteManager::updateCharacterSprite(const CharacterAppearance& ap
     std::cout << "Legacy CharacterSpriteManager called - consider using ModularCharacterSpriteManager" << std::endl;
 }
 
-void CharacterSpriteManager::render(sf::RenderWindow& window, sf::Vector2f position, float scale) {
+void CharacterSpriteManager::render(sf::RenderTarget& target, sf::Vector2f position, float scale) {
     std::cout << "Legacy CharacterSpriteManager render called" << std::endl;
 }
 
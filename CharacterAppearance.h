@@ -8,9 +8,17 @@
 #include "Scene.h"
 #include "Config.h"
 #include "GlitchRenderer.h"
+#include "TextureAtlas.h"
+#include "RenderQueue.h"
+#include "AppearanceCompositeCache.h"
+#include "PaletteRecolor.h"
+#include "Rng.h"
+#include "SdfText.h"
+#include "Widgets.h"
 #include <functional>
 #include <optional>
 #include <array>
+#include <cstdint>
 #include <map>       
 #include <cstdlib>   
 #include <ctime>  
@@ -29,13 +37,28 @@ struct CharacterAppearance {
     int bodyType = 0;
 
     void randomize() {
-        std::srand(static_cast<unsigned>(std::time(nullptr)));
-        gender = std::rand() % 3;
-        hairType = std::rand() % 3;
-        hairColor = std::rand() % 3;
-        skinTone = std::rand() % 3;
-        faceType = std::rand() % 3;
-        bodyType = std::rand() % 3;
+        auto& rng = Rng::instance().stream(RngStreamId::Appearance);
+        gender = rng.nextInt(3);
+        hairType = rng.nextInt(3);
+        hairColor = rng.nextInt(3);
+        skinTone = rng.nextInt(3);
+        faceType = rng.nextInt(3);
+        bodyType = rng.nextInt(3);
+    }
+
+    // Ключ для кэша запеченных изображений (FNV-1a по всем полям)
+    std::uint64_t hash() const {
+        std::uint64_t h = 14695981039346656037ull;
+        for (int value : { gender, hairType, hairColor, skinTone, faceType, bodyType }) {
+            h ^= static_cast<std::uint32_t>(value);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    bool operator==(const CharacterAppearance& other) const {
+        return gender == other.gender && hairType == other.hairType && hairColor == other.hairColor
+            && skinTone == other.skinTone && faceType == other.faceType && bodyType == other.bodyType;
     }
 };
 
@@ -63,74 +86,26 @@ struct AppearanceConfig {
     std::vector<std::string> options;
 };
 
-// Кнопка для интерфейса внешности
-class AppearanceButton {
-private:
-    sf::RectangleShape shape;
-    std::unique_ptr<sf::Text> text;
-    bool isHovered = false;
-    std::function<void()> onClick;
-
-public:
-    AppearanceButton(const sf::Font& font, const std::string& buttonText,
-        sf::Vector2f position, sf::Vector2f size);
-
-    bool contains(sf::Vector2f point) const;
-    void setHovered(bool hovered);
-    void handleClick();
-    void render(sf::RenderWindow& window);
-
-    void setOnClick(std::function<void()> callback) {
-        onClick = callback;
-    }
-};
-
-// Строка конфигурации внешности
-class AppearanceConfigLine {
-private:
-    AppearanceType type;
-    std::vector<std::string> options;
-    int currentIndex = 0;
-
-    std::unique_ptr<sf::Text> nameText;
-    std::unique_ptr<sf::Text> valueText;
-    std::unique_ptr<AppearanceButton> prevButton;
-    std::unique_ptr<AppearanceButton> nextButton;
+// Картинка, из которой получаются части: отдельный PNG варианта или общая серая маска
+struct PartSource {
+    enum class State { Unloaded, Loading, Ready, Failed };
 
-    std::function<void(int)> onValueChanged;
-
-    void updateValueDisplay();
-    void previousOption();
-    void nextOption();
-
-public:
-    AppearanceConfigLine(const sf::Font& font, AppearanceType appearanceType,
-        const std::string& name, const std::vector<std::string>& availableOptions,
-        sf::Vector2f position, float scale = 1.0f);
-
-    void setValue(int value);
-    int getValue() const { return currentIndex; }
-
-    void updateHover(sf::Vector2f mousePos);
-    void handleClick(sf::Vector2f mousePos);
-    void render(sf::RenderWindow& window);
-    void updatePositions(sf::Vector2f position, float scale);
-
-    void setOnValueChanged(std::function<void(int)> callback) {
-        onValueChanged = callback;
-    }
+    std::string path;
+    bool isMask = false;
+    State state = State::Unloaded;
+    std::optional<sf::Image> image;     // CPU-копия; у обычных частей освобождается после попадания в атлас
 };
 
-// Часть персонажа для модульной системы
+// Часть персонажа для модульной системы. Грузится по требованию и живет
+// прямоугольником внутри общего атласа, пока ее не вытеснит бюджет памяти
 struct CharacterPart {
-    sf::Texture texture;
-    sf::Sprite sprite;
-    bool isLoaded = false;
-
-    CharacterPart();
-    bool loadFromFile(const std::string& path);
-    void setPosition(sf::Vector2f pos);
-    void setScale(sf::Vector2f scale);
+    int sourceIndex = -1;
+    int paletteIndex = -1;      // >= 0 — цветовой вариант маски
+    sf::IntRect atlasRect;
+    bool inAtlas = false;
+    bool requested = false;
+    bool failed = false;
+    std::uint64_t lastUsed = 0;
 };
 
 // Модульный менеджер спрайтов персонажа
@@ -143,29 +118,75 @@ private:
     float baseScale = 1.0f;
     bool partsLoaded = false;
 
+    // Загруженные части лежат в одном атласе и рисуются одним draw
+    TextureAtlas atlas;
+    sf::VertexArray partVertices{ sf::PrimitiveType::Triangles };
+    std::size_t loadedImageCount = 0;       // сколько картинок реально декодировано
+    int lastDrawCalls = 0;
+
+    // Каталог источников и палитры для перекраски масок
+    std::vector<PartSource> partSources;
+    std::vector<RecolorPalette> recolorPalettes;
+
+    // Ленивая загрузка: соседи текущей внешности подгружаются в фоне и не вытесняются
+    std::vector<std::pair<size_t, int>> neighbourParts;
+    std::uint64_t useCounter = 0;
+    std::shared_ptr<bool> loadToken;        // гасит ответы загрузчика, пришедшие после пересборки каталога
+
+    // Запеченные комбинации слоев; персонаж меняется только при смене внешности
+    AppearanceCompositeCache compositeCache;
+    std::optional<std::uint64_t> compositeKey;  // nullopt — индексы выставлены не по внешности
+    const sf::Texture* compositeTexture = nullptr;
+
     // Fallback текстуры для отладки
     sf::Texture fallbackTexture;
     sf::Sprite fallbackSprite;
     bool fallbackLoaded = false;
 
-    bool loadPartCategory(PartType partType, const std::string& folderName,
+    bool addPartCategory(PartType partType, const std::string& folderName,
         const std::vector<std::string>& partNames);
+    bool addRecolorCategory(PartType partType, const std::string& folderName,
+        const std::vector<std::string>& styleNames, const std::vector<RecolorPalette>& palettes);
+    std::optional<std::string> resolvePartPath(const std::string& folderName, const std::string& partName) const;
+    bool loadPartImage(const std::string& path, sf::Image& image) const;
+
+    void requestPart(size_t typeIndex, int index, bool urgent);
+    void requestCurrentParts();
+    void prefetchNeighbours(const CharacterAppearance& appearance);
+    void startSourceLoad(int sourceIndex, bool urgent);
+    void onSourceLoaded(int sourceIndex, std::optional<sf::Image>&& image);
+    void placePart(CharacterPart& part);
+    void loadPartNow(size_t typeIndex, int index);
+    bool areCurrentPartsReady() const;
+    std::size_t getResidentBytes() const;
+    void enforceMemoryBudget();
+
+    void appendPartQuad(const CharacterPart& part, sf::Vector2f origin, float scale);
+    void buildPartVertices(sf::Vector2f origin, float scale);
+    std::array<int, static_cast<size_t>(PartType::COUNT)> partIndicesFor(const CharacterAppearance& appearance) const;
+    void selectParts(const CharacterAppearance& appearance);
+    void refreshComposite();
+    const sf::Texture* bakeComposite(std::uint64_t key);
     void createFallbackTexture();
 
 public:
     ModularCharacterSpriteManager();
 
+    // Строит каталог вариантов (только проверка наличия файлов); картинки грузятся по требованию
     bool loadCharacterParts();
     void setPartIndex(PartType partType, int index);
     int getPartCount(PartType partType) const;
     int getCurrentPartIndex(PartType partType) const;
     void updatePartPositions();
     void updateCharacterSprite(const CharacterAppearance& appearance);
-    void render(sf::RenderWindow& window, sf::Vector2f position, float scale = 1.0f);
+    void render(sf::RenderTarget& target, sf::Vector2f position, float scale = 1.0f);
     void randomizeAppearance();
     CharacterAppearance getAppearanceFromParts() const;
     bool arePartsLoaded() const;
     void printDebugInfo() const;
+
+    // Прогоняет все 3^6 комбинаций внешности через кэш и печатает время запекания и попаданий
+    void runCompositeBenchmark();
 };
 
 // Устаревший менеджер спрайтов (для совместимости)
@@ -177,24 +198,24 @@ public:
     bool loadTexture(const std::string& path);
     std::string generateSpritePath(const CharacterAppearance& appearance);
     void updateCharacterSprite(const CharacterAppearance& appearance);
-    void render(sf::RenderWindow& window, sf::Vector2f position, float scale = 1.0f);
+    void render(sf::RenderTarget& target, sf::Vector2f position, float scale = 1.0f);
 };
 
 // Основная сцена внешности персонажа
 class AppearanceScene : public Scene { // ИСПРАВЛЕНО: наследуется от Scene
 private:
     GameConfig& config;
+    SceneParams choices;
 
-    // Ресурсы
-    sf::Font font;
-    sf::Texture backgroundTexture;
-    std::optional<sf::Sprite> backgroundSprite;
+    // Ресурсы (из общего ResourceCache)
+    std::shared_ptr<SdfFont> font;
+    std::shared_ptr<sf::Texture> backgroundTexture;
 
     // UI элементы
-    std::unique_ptr<sf::Text> titleText;
-    std::unique_ptr<AppearanceButton> randomizeButton;
-    std::unique_ptr<AppearanceButton> confirmButton;
-    std::vector<std::unique_ptr<AppearanceConfigLine>> configLines;
+    std::unique_ptr<SdfText> titleText;
+    std::unique_ptr<UiButton> randomizeButton;
+    std::unique_ptr<UiButton> confirmButton;
+    std::vector<std::unique_ptr<UiSpinner>> configLines;
 
     // Данные персонажа
     CharacterAppearance characterData;
@@ -205,10 +226,6 @@ private:
     CharacterSpriteManager spriteManager; // Устаревший, для совместимости
     GlitchRenderer glitchRenderer;
 
-    // Состояние сцены
-    bool finished = false;
-    std::unique_ptr<Scene> nextScene = nullptr; // ДОБАВЛЕНО: для следующей сцены
-
     // Методы инициализации
     void loadResources();
     void initializeAppearanceConfigs();
@@ -216,7 +233,6 @@ private:
     void setupConfigLines();
 
     // Методы обновления
-    void updatePositions(sf::RenderWindow& window);
     void updateHoverStates(sf::Vector2f mousePos);
     void updateCharacterDisplay();
 
@@ -227,17 +243,13 @@ private:
     void confirmSelection();
 
 public:
-    AppearanceScene(GameConfig& config);
+    AppearanceScene(GameConfig& config, SceneParams choices = {});
 
     void update(float deltaTime, sf::RenderWindow& window) override; // ДОБАВЛЕНО: override
-    void render(sf::RenderWindow& window) override; // ДОБАВЛЕНО: override
+    void render(sf::RenderTarget& target) override; // ДОБАВЛЕНО: override
+    void layout(sf::RenderWindow& window) override;
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override; // ДОБАВЛЕНО: override
+    void handleInput(const InputSnapshot& input) override;
 
-    bool isFinished() const override { return finished; } // ДОБАВЛЕНО: override
     const CharacterAppearance& getCharacterData() const { return characterData; }
-
-    // ДОБАВЛЕНО: метод для извлечения следующей сцены
-    std::unique_ptr<Scene> extractNextScene() {
-        return std::move(nextScene);
-    }
 };
\ No newline at end of file
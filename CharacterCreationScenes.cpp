@@ -11,61 +11,31 @@
 #include <SFML/Window/Event.hpp>
 #include <SFML/Graphics.hpp>
 #include <CharacterCreationScenes.h>
-#include "CharacterSpecializationScene.h"
 #include "GlitchRenderer.h"
+#include "ResourceCache.h"
+#include "RenderQueue.h"
+#include "Input.h"
 
-CharacterOrigin::CharacterOrigin(GameConfig& config) : config(config) {
-    bool fontLoaded = false;
-
-    std::vector<std::string> fontPaths = {
-        "assets/fonts/digital-7 (italic).ttf",
-        "arial.ttf",
-        "../assets/fonts/arial.ttf",
-        "C:\\Windows\\Fonts\\arial.ttf",
-        "C:\\Windows\\Fonts\\calibri.ttf"
-    };
-
-    for (const auto& path : fontPaths) {
-        if (font.openFromFile(path)) {  // ИСПРАВЛЕНО: loadFromFile -> openFromFile
-            fontLoaded = true;
-            std::cout << "Font loaded successfully from: " << path << std::endl;
-            break;
-        }
-    }
-
-    if (!fontLoaded) {
-        std::cerr << "Warning: Could not load any font file. Text may not display correctly." << std::endl;
-    }
+CharacterOrigin::CharacterOrigin(GameConfig& config, SceneParams choices)
+    : config(config), choices(std::move(choices)) {
+    auto& cache = ResourceCache::instance();
+    font = cache.getSdfFont("font.ui");
 
-    if (!backgroundTexture.loadFromFile("assets/textures/menu.png")) {
+    backgroundTexture = cache.getTexture("tex.menu");
+    if (backgroundTexture->getSize().x == 0) {
         std::cerr << "Failed to load background image.\n";
     }
-    else {
-        backgroundSprite.emplace(backgroundTexture);
-    }
 
-    // ИСПРАВЛЕНО: В SFML 3 sf::Text требует font в конструкторе
-    OriginText = std::make_unique<sf::Text>(font, "CHOOSE YOUR ORIGIN");
-    OriginText->setCharacterSize(100);
+    OriginText = std::make_unique<SdfText>(font, "CHOOSE YOUR ORIGIN", 100);
     OriginText->setFillColor(sf::Color(139, 0, 0)); // setFillColor вместо setColor
     OriginText->setPosition(sf::Vector2f(10.f, 10.f));
 
     // Если используется menuItems, убедись, что оно объявлено (vector<sf::Drawable*> menuItems;)
     menuItems.push_back(OriginText.get());
 
-    // Загрузка кнопок (обновлено для хранения текстур)
-    for (const auto& [label, texturePath] : origins) {
-        auto tex = std::make_shared<sf::Texture>();
-        if (!tex->loadFromFile(texturePath)) {
-            std::cerr << "Failed to load texture for " << label << ": " << texturePath << std::endl;
-        }
-        textures.push_back(tex); // сохраняем чтобы не удалялись
-
-        OriginButton button(font);
-        button.setTexture(tex);
-        button.label = label;
-        button.labelText.setString(label);
-        originButtons.push_back(std::move(button));
+    // Картинки карточек копируются в общий атлас, поэтому текстуры держать не нужно
+    for (const auto& [label, textureId] : origins) {
+        originButtons.emplace_back(font, label, textureId);
     }
 
     // Настройка глитч эффектов
@@ -75,61 +45,39 @@ CharacterOrigin::CharacterOrigin(GameConfig& config) : config(config) {
 
 void CharacterOrigin::update(float dt, sf::RenderWindow& window) {
     glitchRenderer.update(dt);
-    updatePositions(window);
+}
 
-    sf::Vector2f mouseWorld = window.mapPixelToCoords(sf::Mouse::getPosition(window));
+void CharacterOrigin::setHoveredCard(int index) {
+    if (index == hoveredIndex) return;
 
-    for (auto& btn : originButtons) {
-        if (btn.getBounds().contains(mouseWorld)) {
-            btn.border.setOutlineColor(sf::Color::Yellow);
-            // Можно добавить дополнительные эффекты при наведении
-        }
-        else {
-            btn.border.setOutlineColor(sf::Color::Green);
-        }
-    }
+    if (hoveredIndex != -1) originButtons[hoveredIndex].setHovered(false);
+    if (index != -1) originButtons[index].setHovered(true);
+    hoveredIndex = index;
 }
 
-void CharacterOrigin::render(sf::RenderWindow& window) {
-    std::cout << "Rendering background..." << std::endl;
-    if (backgroundSprite.has_value()) {
-        auto windowSize = window.getSize();
-        auto textureSize = backgroundTexture.getSize();
-        float scaleX = static_cast<float>(windowSize.x) / textureSize.x;
-        float scaleY = static_cast<float>(windowSize.y) / textureSize.y;
-        float scale = std::max(scaleX, scaleY);
-        backgroundSprite->setScale(sf::Vector2f(scale, scale));
-        window.draw(backgroundSprite.value());
-    }
-
-    std::cout << "Rendering glitch..." << std::endl;
-    glitchRenderer.renderBackground(window, backgroundTexture);
+void CharacterOrigin::render(sf::RenderTarget& target) {
+    // Фон целиком рисует GlitchRenderer из запеченного слоя
+    glitchRenderer.renderBackground(target, *backgroundTexture);
 
-    std::cout << "Rendering origin text..." << std::endl;
     // Рендерим главный заголовок с глитч эффектом
-    //glitchRenderer.renderGlitchText(window, *OriginText, "CHOOSE YOUR ORIGIN");
-    window.draw(*OriginText);
+    //glitchRenderer.renderGlitchText(target, *OriginText);
+    auto& queue = RenderQueue::instance();
+    queue.submit(*OriginText, RenderQueue::LAYER_TEXT);
 
-    std::cout << "Rendering buttons..." << std::endl;
+    // Картинки из атласа, рамки и подписи с призраками — по одному пакету на всех
     for (auto& btn : originButtons) {
-        // Рендерим спрайты кнопок
-        if (btn.sprite) window.draw(*btn.sprite);
-        window.draw(btn.border);
-
-        // Рендерим текст кнопок с глитч эффектом
-        glitchRenderer.renderGlitchText(window, btn.labelText, btn.label);
-        window.draw(btn.labelText);
-
-        // Добавляем hover глитч эффект при наведении мыши
-        sf::Vector2f mouseWorld = window.mapPixelToCoords(sf::Mouse::getPosition(window));
-        if (btn.getBounds().contains(mouseWorld)) {
-            glitchRenderer.renderHoverGlitch(window, btn.getBounds());
-        }
+        glitchRenderer.renderGlitchText(target, btn.getLabelText());
+        btn.render(queue);
     }
 
-    std::cout << "Render complete.\n";
+    // Добавляем hover глитч эффект при наведении мыши
+    if (hoveredIndex != -1) {
+        glitchRenderer.renderHoverGlitch(target, originButtons[hoveredIndex].getBounds());
+    }
+
+    queue.flush(target);
 
-    glitchRenderer.renderGlitchLines(window, 15);
+    glitchRenderer.renderGlitchLines(target, 15);
 
     // Включение затемнения на 30%
     glitchRenderer.setBackgroundDarkening(true, 0.3f);
@@ -141,49 +89,39 @@ void CharacterOrigin::render(sf::RenderWindow& window) {
     glitchRenderer.setCyberpunkSquares(true);
 
     // В цикле рендеринга
-    glitchRenderer.renderCyberpunkSquares(window, 8); // 8 квадратов
+    glitchRenderer.renderCyberpunkSquares(target, 8); // 8 квадратов
+
+    glitchRenderer.flushOverlay(target);
 }
 
 void CharacterOrigin::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
+    const std::optional<Action> action = Input::instance().getAction(event);
+
     // ИСПРАВЛЕНО: В SFML 3 новый API для событий
-    if (const auto* mousePressed = event.getIf<sf::Event::MouseButtonPressed>()) {
-        sf::Vector2f worldPos = window.mapPixelToCoords({ mousePressed->position.x, mousePressed->position.y });
-
-        for (const auto& btn : originButtons) {
-            if (btn.contains(worldPos)) {
-                std::cout << btn.label << " selected\n";
-                nextScene = std::make_unique<CharacterSpecialization>(config);
-                finished = true;
-                break;
-            }
-        }
+    if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+        setHoveredCard(hitGrid.hitTest(window.mapPixelToCoords(moved->position)));
+    }
+    else if (event.is<sf::Event::MouseLeft>()) {
+        setHoveredCard(-1);
     }
-    else if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>()) {
-        // ИСПРАВЛЕНО: Scoped enum для клавиш
-        if (keyPressed->code == sf::Keyboard::Key::Enter) {
-            std::cout << "Enter key pressed\n";
+    else if (const auto* mousePressed = event.getIf<sf::Event::MouseButtonPressed>(); mousePressed && action == Action::Select) {
+        int index = hitGrid.hitTest(window.mapPixelToCoords(mousePressed->position));
+        if (index != -1) {
+            std::cout << originButtons[index].getLabel() << " selected\n";
+            choices["origin"] = originButtons[index].getLabel();
+            requestTransition(SceneTransition::replace(SceneId::CharacterSpecialization, choices));
         }
     }
 }
 
-bool CharacterOrigin::isFinished() const {
-    return finished;
-}
-
-std::unique_ptr<Scene> CharacterOrigin::extractNextScene() {
-    return std::move(nextScene);
+void CharacterOrigin::handleInput(const InputSnapshot& input) {
+    if (input.wasPressed(Action::Confirm)) {
+        std::cout << "Enter key pressed\n";
+    }
 }
 
-void CharacterOrigin::updatePositions(sf::RenderWindow& window) {
-    auto windowSize = window.getSize();
-
-    const float baseWidth = 1280.f;
-    const float baseHeight = 720.f;
-
-    float scaleX = static_cast<float>(windowSize.x) / baseWidth;
-    float scaleY = static_cast<float>(windowSize.y) / baseHeight;
-    float scale = std::min(scaleX, scaleY);
-
+void CharacterOrigin::layout(sf::RenderWindow& window) {
+    // Координаты холста 1280x720; SDF-подписи остаются четкими при любом масштабе вида
     const float baseX = 50.f;
     const float baseY = 180.f;
     const float buttonWidth = 200.f;
@@ -191,14 +129,19 @@ void CharacterOrigin::updatePositions(sf::RenderWindow& window) {
     const float spacing = 5.f;
 
     for (size_t i = 0; i < originButtons.size(); ++i) {
-        float x = (baseX + i * (buttonHeight + spacing)) * scaleX;
-        float y = baseY * scaleY;
+        float x = baseX + i * (buttonHeight + spacing);
+        float y = baseY;
 
-        // ИСПРАВЛЕНО: sf::Vector2f вместо отдельных параметров
+        originButtons[i].setSize({ buttonWidth, buttonHeight });
         originButtons[i].setPosition({ x, y });
-        originButtons[i].setSize({ buttonWidth * scaleX, buttonHeight * scaleY });
-        originButtons[i].labelText.setCharacterSize(static_cast<unsigned int>(36 * scale));
-        originButtons[i].labelText.setPosition({ x + 10.f, y + buttonHeight * scaleY + 10.f });
+        originButtons[i].setLabelSize(36);
+    }
+
+    hitGrid.clear();
+    for (size_t i = 0; i < originButtons.size(); ++i) {
+        hitGrid.insert(static_cast<int>(i), originButtons[i].getBounds());
     }
+    auto pointer = Input::instance().getSnapshot().getPointer(window);
+    setHoveredCard(pointer ? hitGrid.hitTest(*pointer) : -1);
 }
 
@@ -6,88 +6,43 @@
 #include "Scene.h"
 #include "Config.h"
 #include "GlitchRenderer.h"
+#include "Widgets.h"
+#include "HitGrid.h"
 #include <iostream>
 
-struct OriginButton {
-    std::optional<sf::Sprite> sprite; 
-    sf::Text labelText;
-    sf::RectangleShape border;
-    std::string label;
-    std::shared_ptr<sf::Texture> texture;
-
-    OriginButton(const sf::Font& font)
-        : labelText(font, "")
-    {
-        border.setFillColor(sf::Color::Transparent);
-        border.setOutlineThickness(1.f);
-        border.setOutlineColor(sf::Color::Green);
-        labelText.setCharacterSize(32);
-        labelText.setFillColor(sf::Color(139, 0, 0));
-    }
-
-    void setTexture(std::shared_ptr<sf::Texture> tex) {
-        texture = tex;
-        if (texture && texture->getSize().x > 0) {
-            sprite = sf::Sprite(*texture); // теперь можно
-        }
-    }
-
-    void setPosition(const sf::Vector2f& pos) {
-        if (sprite) sprite->setPosition(pos);
-        border.setPosition(pos);
-        labelText.setPosition({ pos.x + 10.f, pos.y + border.getSize().y + 10.f });
-    }
-
-    void setSize(const sf::Vector2f& size) {
-        border.setSize(size);
-        if (texture && texture->getSize().x > 0 && sprite) {
-            float scaleX = size.x / static_cast<float>(texture->getSize().x);
-            float scaleY = size.y / static_cast<float>(texture->getSize().y);
-            sprite->setScale({ scaleX, scaleY });
-        }
-    }
-
-    sf::FloatRect getBounds() const {
-        return border.getGlobalBounds();
-    }
-
-    bool contains(const sf::Vector2f& point) const {
-        return getBounds().contains(point);
-    }
-};
-
 class CharacterOrigin : public Scene {
 private:
 
     std::vector<std::pair<std::string, std::string>> origins = {
-        {"Punk", "assets/textures/z.png"},
-        {"Corpo", "assets/textures/corpo.png"},
-        {"Street", "assets/textures/street.png"},
-        {"Tech", "assets/textures/tech.png" }
+        {"Punk", "tex.card.punk"},
+        {"Corpo", "tex.card.corpo"},
+        {"Street", "tex.card.street"},
+        {"Tech", "tex.card.tech" }
     };
 
-    sf::Texture backgroundTexture;
-    std::optional<sf::Sprite> backgroundSprite;
-    std::vector<OriginButton> originButtons;
-    std::vector<std::shared_ptr<sf::Texture>> textures; // Храним текстуры здесь!
-    sf::Font font;
+    std::shared_ptr<sf::Texture> backgroundTexture;
+    std::vector<UiCard> originButtons;
+    std::shared_ptr<SdfFont> font;
     GameConfig& config;
-    std::unique_ptr<sf::Text> OriginText;
+    SceneParams choices;
+    std::unique_ptr<SdfText> OriginText;
     GlitchRenderer glitchRenderer;
-    std::unique_ptr<Scene> nextScene;
-    bool finished = false;
     std::vector<sf::Drawable*> menuItems;
 
+    // Границы карточек кэшируются в layout(); наведение меняется только на MouseMoved
+    HitGrid hitGrid;
+    int hoveredIndex = -1;
+    void setHoveredCard(int index);
+
 
-    void updatePositions(sf::RenderWindow& window);
 
 public:
-    CharacterOrigin(GameConfig& config);
+    CharacterOrigin(GameConfig& config, SceneParams choices = {});
     void update(float deltaTime, sf::RenderWindow& window) override;
-    void render(sf::RenderWindow& window) override;
+    void render(sf::RenderTarget& target) override;
+    void layout(sf::RenderWindow& window) override;
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
-    bool isFinished() const override;
-    std::unique_ptr<Scene> extractNextScene();
+    void handleInput(const InputSnapshot& input) override;
 };
 
 
@@ -10,59 +10,33 @@
 #include <SFML/Window/Event.hpp>
 #include <SFML/Graphics.hpp>
 #include <CharacterCreationScenes.h>
-#include <CharacterSpecializationScene.h>
 #include <CharacterFreePointsDistributionScene.h>
-#include <CharacterAppearance.h>
 #include "GlitchRenderer.h"
+#include "ResourceCache.h"
+#include "Input.h"
 
 namespace {
     // UI Constants
-    constexpr float BASE_WIDTH = 1280.0f;
-    constexpr float BASE_HEIGHT = 720.0f;
     constexpr unsigned int TITLE_SIZE = 48;
     constexpr unsigned int TEXT_SIZE = 24;
     const sf::Color MENU_COLOR(139, 0, 0);
     const sf::Color TEXT_COLOR(139, 0, 0);
-
-    // Font paths to try
-    const std::vector<std::string> FONT_PATHS = {
-        "assets/fonts/digital-7 (italic).ttf",
-        "arial.ttf",
-        "../assets/fonts/arial.ttf",
-        "C:\\Windows\\Fonts\\arial.ttf",
-        "C:\\Windows\\Fonts\\calibri.ttf"
-    };
 }
 
-FreePoints::FreePoints(GameConfig& config)
-    : config(config) {
-    std::srand(std::time(nullptr));
+FreePoints::FreePoints(GameConfig& config, SceneParams choices)
+    : config(config), choices(std::move(choices)) {
+    // Shared SDF font: resizing only rescales text, no glyph pages are rasterized
+    auto& cache = ResourceCache::instance();
+    font = cache.getSdfFont("font.ui");
 
-    // Load font first
-    bool fontLoaded = false;
-    for (const auto& path : FONT_PATHS) {
-        if (font.openFromFile(path)) {
-            fontLoaded = true;
-            std::cout << "Font loaded successfully from: " << path << std::endl;
-            break;
-        }
-    }
+    titleText = std::make_unique<SdfText>(font, "");
+    remainingPointsText = std::make_unique<SdfText>(font, "");
 
-    if (!fontLoaded) {
-        std::cerr << "Warning: Could not load any font file. Text may not display correctly." << std::endl;
-    }
-
-    // Initialize text objects after font is loaded (font first in SFML 3.1)
-    titleText = std::make_unique<sf::Text>(font, "");
-    remainingPointsText = std::make_unique<sf::Text>(font, "");
-
-    // Load background
-    if (!backgroundTexture.loadFromFile("assets/textures/menu.png")) {
+    // Shared background
+    backgroundTexture = cache.getTexture("tex.menu");
+    if (backgroundTexture->getSize().x == 0) {
         std::cerr << "Failed to load background image.\n";
     }
-    else {
-        backgroundSprite.emplace(backgroundTexture);
-    }
 
     initializeUI();
 }
@@ -79,120 +53,101 @@ void FreePoints::initializeUI() {
     updateRemainingPointsDisplay();
 
     // Setup skill lines
-    setupSkillLine(SkillType::TECH, "Technology", 0);
-    setupSkillLine(SkillType::INTELLECT, "Intellect", 1);
-    setupSkillLine(SkillType::BIOMOD, "Bio-modifications", 2);
-    setupSkillLine(SkillType::SOCIAL, "Social", 3);
-    setupSkillLine(SkillType::PHYSICAL, "Physical", 4);
-    setupSkillLine(SkillType::COMBAT, "Combat", 5);
+    setupSkillLine(SkillType::TECH, "Technology");
+    setupSkillLine(SkillType::INTELLECT, "Intellect");
+    setupSkillLine(SkillType::BIOMOD, "Bio-modifications");
+    setupSkillLine(SkillType::SOCIAL, "Social");
+    setupSkillLine(SkillType::PHYSICAL, "Physical");
+    setupSkillLine(SkillType::COMBAT, "Combat");
 }
 
-void FreePoints::setupSkillLine(SkillType type, const std::string& name, float yOffset) {
+void FreePoints::setupSkillLine(SkillType type, const std::string& name) {
     size_t index = static_cast<size_t>(type);
-    sf::Vector2f basePosition(100.0f, 200.0f + yOffset * 60.0f);
+    skillLines[index] = std::make_unique<UiStepper>(font, name);
 
-    skillLines[index] = std::make_unique<SkillLine>(font, name, type, basePosition);
-
-    // Setup button callbacks
-    skillLines[index]->plusButton->onClick = [this, type]() {
-        addPoint(type);
-        };
-
-    skillLines[index]->minusButton->onClick = [this, type]() {
-        removePoint(type);
-        };
+    // The stepper only reports the step; point rules stay in the scene
+    skillLines[index]->setCanStep([this, type](int step) {
+        return step > 0 ? canAddPoint(type) : canRemovePoint(type);
+        });
+    skillLines[index]->setOnStep([this, type](int step) {
+        if (step > 0) addPoint(type);
+        else removePoint(type);
+        });
 }
 
 void FreePoints::update(float deltaTime, sf::RenderWindow& window) {
-    updatePositions(window);
-
-    // Update hover states
-    sf::Vector2i pixelPos = sf::Mouse::getPosition(window);
-    sf::Vector2f mousePos = window.mapPixelToCoords(pixelPos);
-    updateButtonHover(mousePos);
-
+    // Hover is driven by MouseMoved events, nothing to poll here
     glitchRenderer.update(deltaTime);
 }
 
 void FreePoints::updateButtonHover(sf::Vector2f mousePos) {
     for (auto& skillLine : skillLines) {
         if (skillLine) {
-            bool plusHovered = skillLine->plusButton->contains(mousePos);
-            bool minusHovered = skillLine->minusButton->contains(mousePos);
-
-            skillLine->plusButton->setHovered(plusHovered && canAddPoint(skillLine->type));
-            skillLine->minusButton->setHovered(minusHovered && canRemovePoint(skillLine->type));
+            skillLine->updateHover(mousePos);
         }
     }
 }
 
-void FreePoints::render(sf::RenderWindow& window) {
-    // Background
-    if (backgroundSprite.has_value()) {
-        auto windowSize = window.getSize();
-        auto textureSize = backgroundTexture.getSize();
-
-        float scaleX = static_cast<float>(windowSize.x) / textureSize.x;
-        float scaleY = static_cast<float>(windowSize.y) / textureSize.y;
-
-        backgroundSprite->setScale(sf::Vector2f(scaleX, scaleY));
-        window.draw(backgroundSprite.value());
-    }
-
-    // Glitch background effects
-    glitchRenderer.renderBackground(window, backgroundTexture);
+void FreePoints::render(sf::RenderTarget& target) {
+    // Background: baked, darkened layer plus glitch effects in one pass
+    glitchRenderer.renderBackground(target, *backgroundTexture);
 
     // UI Elements
-    glitchRenderer.renderGlitchText(window, *titleText, "NEUROCIPHER REBOOT");
-    window.draw(*titleText);
+    auto& queue = RenderQueue::instance();
+    glitchRenderer.renderGlitchText(target, *titleText);
+    queue.submit(*titleText, RenderQueue::LAYER_TEXT);
 
-    window.draw(*remainingPointsText);
+    queue.submit(*remainingPointsText, RenderQueue::LAYER_TEXT);
 
-    // Skill lines
+    // Skill lines: button boxes in one batch, labels and values in another
     for (const auto& skillLine : skillLines) {
         if (skillLine) {
-            skillLine->render(window);
+            skillLine->render(queue);
         }
     }
+    queue.flush(target);
 
     // Glitch effects
-    glitchRenderer.renderGlitchLines(window, 15);
+    glitchRenderer.renderGlitchLines(target, 15);
     glitchRenderer.setBackgroundDarkening(true, 0.5f);
     glitchRenderer.setAnalogGlitch(true);
     glitchRenderer.setCyberpunkSquares(true);
-    glitchRenderer.renderCyberpunkSquares(window, 8);
+    glitchRenderer.renderCyberpunkSquares(target, 8);
+
+    glitchRenderer.flushOverlay(target);
 }
 
 void FreePoints::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
-    if (event.getIf<sf::Event::MouseButtonPressed>()) {
-        sf::Vector2i pixelPos = sf::Mouse::getPosition(window);
-        sf::Vector2f worldPos = window.mapPixelToCoords(pixelPos);
-        handleButtonClick(worldPos);
+    const std::optional<Action> action = Input::instance().getAction(event);
+
+    if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+        updateButtonHover(window.mapPixelToCoords(moved->position));
+    }
+    else if (event.is<sf::Event::MouseLeft>()) {
+        // Cursor left the window: a point off the canvas clears every hover
+        updateButtonHover(sf::Vector2f(-1.0f, -1.0f));
+    }
+    else if (const auto* pressed = event.getIf<sf::Event::MouseButtonPressed>(); pressed && action == Action::Select) {
+        handleButtonClick(window.mapPixelToCoords(pressed->position));
     }
+}
 
-    if (const auto* keyEvent = event.getIf<sf::Event::KeyPressed>()) {
-        if (keyEvent->scancode == sf::Keyboard::Scancode::Enter) {
-            if (remainingPoints == 0) {
-                std::cout << "Character creation completed! Moving to next screen...\n";
-                nextScene = std::make_unique<AppearanceScene>(config);
-                finished = true;
-            }
-            else {
-                std::cout << "Please distribute all points before continuing. Remaining: " << remainingPoints << "\n";
-            }
+void FreePoints::handleInput(const InputSnapshot& input) {
+    if (input.wasPressed(Action::Confirm)) {
+        if (remainingPoints == 0) {
+            std::cout << "Character creation completed! Moving to next screen...\n";
+            requestTransition(SceneTransition::replace(SceneId::Appearance, choices));
+        }
+        else {
+            std::cout << "Please distribute all points before continuing. Remaining: " << remainingPoints << "\n";
         }
     }
 }
 
 void FreePoints::handleButtonClick(sf::Vector2f mousePos) {
     for (auto& skillLine : skillLines) {
-        if (skillLine) {
-            if (skillLine->plusButton->contains(mousePos) && canAddPoint(skillLine->type)) {
-                skillLine->plusButton->onClick();
-            }
-            else if (skillLine->minusButton->contains(mousePos) && canRemovePoint(skillLine->type)) {
-                skillLine->minusButton->onClick();
-            }
+        if (skillLine && skillLine->handleClick(mousePos)) {
+            break;
         }
     }
 }
@@ -212,8 +167,7 @@ void FreePoints::addPoint(SkillType type) {
         skillValues[index]++;
         remainingPoints--;
 
-        skillLines[index]->currentValue = skillValues[index];
-        skillLines[index]->updateValue();
+        skillLines[index]->setValue(skillValues[index]);
         updateRemainingPointsDisplay();
 
         std::cout << "Added point to skill " << static_cast<int>(type)
@@ -227,8 +181,7 @@ void FreePoints::removePoint(SkillType type) {
         skillValues[index]--;
         remainingPoints++;
 
-        skillLines[index]->currentValue = skillValues[index];
-        skillLines[index]->updateValue();
+        skillLines[index]->setValue(skillValues[index]);
         updateRemainingPointsDisplay();
 
         std::cout << "Removed point from skill " << static_cast<int>(type)
@@ -251,67 +204,24 @@ void FreePoints::updateRemainingPointsDisplay() {
     }
 }
 
-void FreePoints::updatePositions(sf::RenderWindow& window) {
-    auto windowSize = window.getSize();
-
-    float scaleX = static_cast<float>(windowSize.x) / BASE_WIDTH;
-    float scaleY = static_cast<float>(windowSize.y) / BASE_HEIGHT;
-    float scale = std::min(scaleX, scaleY);
-
-    // Update title position
-    titleText->setCharacterSize(static_cast<unsigned int>(TITLE_SIZE * scale));
-    titleText->setPosition(sf::Vector2f(100.0f * scaleX, 50.0f * scaleY));
+void FreePoints::layout(sf::RenderWindow& window) {
+    // Positions are in 1280x720 virtual-canvas units; the view does the scaling,
+    // and SDF text stays sharp at any size, so this only runs on resize
+    titleText->setCharacterSize(TITLE_SIZE);
+    titleText->setPosition(sf::Vector2f(100.0f, 50.0f));
 
-    // Update remaining points position
-    remainingPointsText->setCharacterSize(static_cast<unsigned int>(TEXT_SIZE * scale));
-    remainingPointsText->setPosition(sf::Vector2f(100.0f * scaleX, 120.0f * scaleY));
+    remainingPointsText->setCharacterSize(TEXT_SIZE);
+    remainingPointsText->setPosition(sf::Vector2f(100.0f, 120.0f));
 
-    // Update skill lines positions
+    // Skill lines
     for (size_t i = 0; i < skillLines.size(); ++i) {
         if (skillLines[i]) {
-            float yPos = (200.0f + i * 60.0f) * scaleY;
-            sf::Vector2f basePos(100.0f * scaleX, yPos);
-
-            // Update text positions and sizes
-            skillLines[i]->nameText->setCharacterSize(static_cast<unsigned int>(TEXT_SIZE * scale));
-            skillLines[i]->nameText->setPosition(basePos);
-
-            skillLines[i]->valueText->setCharacterSize(static_cast<unsigned int>(TEXT_SIZE * scale));
-            skillLines[i]->valueText->setPosition(sf::Vector2f(basePos.x + 300 * scale, basePos.y));
-
-            // Update button positions and sizes
-            sf::Vector2f buttonSize(30 * scale, 30 * scale);
-
-            skillLines[i]->minusButton->shape.setSize(buttonSize);
-            skillLines[i]->minusButton->shape.setPosition(sf::Vector2f(basePos.x + 350 * scale, basePos.y - 3 * scale));
-
-            skillLines[i]->plusButton->shape.setSize(buttonSize);
-            skillLines[i]->plusButton->shape.setPosition(sf::Vector2f(basePos.x + 390 * scale, basePos.y - 3 * scale));
-            skillLines[i]->plusButton->text->setCharacterSize(static_cast<unsigned int>(20 * scale));
-            skillLines[i]->minusButton->text->setCharacterSize(static_cast<unsigned int>(20 * scale));
-
-            // Recenter button text
-            auto centerButtonText = [](SkillButton& button, sf::Vector2f buttonPos, sf::Vector2f buttonSize) {
-                if (button.text) {
-                    sf::FloatRect textBounds = button.text->getLocalBounds();
-                    button.text->setPosition(sf::Vector2f(
-                        buttonPos.x + (buttonSize.x - textBounds.size.x) / 2.0f - textBounds.position.x,
-                        buttonPos.y + (buttonSize.y - textBounds.size.y) / 2.0f - textBounds.position.y
-                    ));
-                }
-                };
-
-            centerButtonText(*skillLines[i]->minusButton, skillLines[i]->minusButton->shape.getPosition(), buttonSize);
-            centerButtonText(*skillLines[i]->plusButton, skillLines[i]->plusButton->shape.getPosition(), buttonSize);
+            skillLines[i]->setPosition(sf::Vector2f(100.0f, 200.0f + i * 60.0f));
         }
     }
-}
-
-bool FreePoints::isFinished() const {
-    return finished;
-}
 
-std::unique_ptr<Scene> FreePoints::extractNextScene() {
-    return std::move(nextScene);
+    // Buttons moved under a resting cursor: re-check hover once
+    auto pointer = Input::instance().getSnapshot().getPointer(window);
+    updateButtonHover(pointer.value_or(sf::Vector2f(-1.0f, -1.0f)));
 }
 
@@ -1,4 +1,4 @@
-// Config.h
+﻿// Config.h
 #pragma once
 #include <SFML/Window.hpp>
 
@@ -7,6 +7,12 @@ struct GameConfig {
     unsigned int height = 720;
     bool fullscreen = false;
     bool vsync = true;
+
+    // Доля разрешения окна, в которой рисуется сцена (0.5 - 1.0); текст остается в родном разрешении
+    float renderScale = 1.0f;
+
+    // Ограничение кадров без vsync; 0 — без ограничения
+    unsigned int frameLimit = 144;
 };
 
 struct Resolution {
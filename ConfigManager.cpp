@@ -24,6 +24,8 @@ GameConfig ConfigManager::load() {
         else if (key == "height") in >> cfg.height;
         else if (key == "fullscreen") in >> cfg.fullscreen;
         else if (key == "vsync") in >> cfg.vsync;
+        else if (key == "renderScale") in >> cfg.renderScale;
+        else if (key == "frameLimit") in >> cfg.frameLimit;
     }
     return cfg;
 }
@@ -33,5 +35,7 @@ void ConfigManager::save(const GameConfig& cfg) {
     out << "width " << cfg.width << "\n"
         << "height " << cfg.height << "\n"
         << "fullscreen " << (cfg.fullscreen ? 1 : 0) << "\n"
-        << "vsync " << (cfg.vsync ? 1 : 0) << "\n";
+        << "vsync " << (cfg.vsync ? 1 : 0) << "\n"
+        << "renderScale " << cfg.renderScale << "\n"
+        << "frameLimit " << cfg.frameLimit << "\n";
 }
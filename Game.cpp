@@ -1,4 +1,4 @@
-#include "Game.h"
+﻿#include "Game.h"
 #include <optional>
 #include "Config.h"
 #include "ConfigManager.h"
@@ -6,9 +6,58 @@
 #include <SFML/Config.hpp>
 #include <SFML/Graphics.hpp>
 #include <cstdint>
+#include <algorithm>
+#include <thread>
+#include <iostream>
+#include "AssetLoader.h"
+#include "ResolutionScaler.h"
+#include "GlitchRenderer.h"
+#include "VirtualCanvas.h"
+#include "Input.h"
+
+namespace {
+    // Все, что нужно меню и созданию персонажа, декодируется, пока показан сплэш
+    const std::vector<std::string> PRELOAD_ASSETS = {
+        "font.ui",
+        "tex.splash",
+        "tex.menu",
+        "tex.settings",
+        "tex.card.punk",
+        "tex.card.corpo",
+        "tex.card.street",
+        "tex.card.tech"
+    };
+
+    // Сколько главный поток может тратить на выгрузку в GPU за кадр
+    const sf::Time UPLOAD_BUDGET = sf::milliseconds(4);
+
+    // Политика вывода: окно без фокуса работает на низкой частоте, статичная сцена,
+    // которую ничто не инвалидировало, только опрашивает ввод и не перерисовывается
+    const sf::Time UNFOCUSED_FRAME_TIME = sf::milliseconds(100);
+    const sf::Time IDLE_FRAME_TIME = sf::milliseconds(16);
+
+    // Симуляция идет фиксированными шагами, чтобы таймеры вели себя одинаково при любой частоте кадров
+    const float FIXED_STEP = 1.f / 60.f;
+    // Защита от спирали смерти: долгий кадр обрезается, догоняют не больше стольких шагов
+    const float MAX_FRAME_DELTA = 0.25f;
+    const int MAX_STEPS_PER_FRAME = 8;
+
+    // Сон ОС грубый (до ~15 мс на Windows), поэтому последний отрезок до срока ждем в цикле
+    const sf::Time SPIN_THRESHOLD = sf::milliseconds(2);
+
+    void waitUntil(const sf::Clock& clock, sf::Time deadline) {
+        sf::Time remaining = deadline - clock.getElapsedTime();
+        if (remaining > SPIN_THRESHOLD) {
+            sf::sleep(remaining - SPIN_THRESHOLD);
+        }
+        while (clock.getElapsedTime() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+}
 
 Game::Game() : sceneManager(ConfigManager::load()) {
-    GameConfig cfg = ConfigManager::load();
+    cfg = ConfigManager::load();
 
     sf::VideoMode mode(sf::Vector2u(cfg.width, cfg.height));
 
@@ -20,29 +69,123 @@ Game::Game() : sceneManager(ConfigManager::load()) {
     }
 
     window.setVerticalSyncEnabled(cfg.vsync);
+    window.setView(VirtualCanvas::makeView(window.getSize()));
+    ResolutionScaler::instance().configure(cfg);
+
+    AssetLoader::instance().preload(PRELOAD_ASSETS);
+    Input::instance().syncPointer(window);
+
     sceneManager = SceneManager(cfg);
     sceneManager.setGame(this);
 }
 
 void Game::run() {
     sf::Clock clock;
+    sf::Clock frameClock;
+    float accumulator = 0.f;
+    Input& input = Input::instance();
+
+    // Любое доставленное событие может изменить картинку
+    auto dispatch = [this, &input](const sf::Event& event) {
+        sceneManager.handleEvent(event, window);
+        sceneManager.invalidate();
+        input.noteDispatched();
+    };
 
     while (window.isOpen()) {
-        
+        frameClock.restart();
+        input.beginFrame();
+
         while (const std::optional<sf::Event> event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) {
                 window.close();
             }
-            sceneManager.handleEvent(*event, window);  
+            else if (const auto* resized = event->getIf<sf::Event::Resized>()) {
+                // Сцены раскладываются на виртуальном холсте; меняются только вид и текст в пикселях окна
+                window.setView(VirtualCanvas::makeView(resized->size));
+                sceneManager.invalidateLayout();
+            }
+            else if (event->is<sf::Event::FocusLost>()) {
+                focused = false;
+                GlitchRenderer::setPaused(true);
+            }
+            else if (event->is<sf::Event::FocusGained>()) {
+                focused = true;
+                GlitchRenderer::setPaused(false);
+            }
+
+            // Движения мыши придерживаются и схлопываются; придержанное доставляется перед
+            // следующим событием другого типа, чтобы сцены видели их по порядку
+            if (input.process(*event)) {
+                if (auto move = input.takePendingMove()) {
+                    dispatch(*move);
+                }
+                dispatch(*event);
+            }
+        }
+        if (auto move = input.takePendingMove()) {
+            dispatch(*move);
+        }
+        input.endFrame();
+        sceneManager.handleInput(input.getSnapshot());
+
+        if (AssetLoader::instance().pump(UPLOAD_BUDGET) > 0) {
+            sceneManager.invalidate();
         }
 
         float dt = clock.restart().asSeconds();
-        sceneManager.update(dt, window);  
+        accumulator += std::min(dt, MAX_FRAME_DELTA);
+        int steps = 0;
+        while (accumulator >= FIXED_STEP) {
+            if (steps == MAX_STEPS_PER_FRAME) {
+                // Отстаем: сбрасываем долг, а не симулируем все более длинные кадры
+                std::cout << "Game: dropped " << accumulator * 1000.f << " ms of simulation" << std::endl;
+                accumulator = 0.f;
+                break;
+            }
+            sceneManager.update(FIXED_STEP, window);  
+            accumulator -= FIXED_STEP;
+            steps++;
+        }
+        float alpha = accumulator / FIXED_STEP;
+
+        // Последняя сцена сняла себя со стека: показывать больше нечего
+        if (sceneManager.isFinished()) {
+            window.close();
+            continue;
+        }
+
+        bool presented = sceneManager.needsRedraw();
+        if (presented) {
+            window.clear();
+            sceneManager.render(window, alpha);  
+            window.display();
+        }
+
+        // Политика вывода; ограничение кадров действует только без vsync
+        sf::Time frameTime = sf::Time::Zero;
+        if (!focused) {
+            frameTime = UNFOCUSED_FRAME_TIME;
+        }
+        else if (!presented) {
+            frameTime = IDLE_FRAME_TIME;
+        }
+        else if (!cfg.vsync && cfg.frameLimit > 0) {
+            frameTime = sf::seconds(1.f / static_cast<float>(cfg.frameLimit));
+        }
 
-        window.clear();
-        sceneManager.render(window);  
-        window.display();
+        if (frameTime > sf::Time::Zero) {
+            // Приторможенным и простаивающим кадрам хватает грубого сна; ограничение кадров ждет точно
+            if (presented && focused) {
+                waitUntil(frameClock, frameTime);
+            }
+            else if (frameClock.getElapsedTime() < frameTime) {
+                sf::sleep(frameTime - frameClock.getElapsedTime());
+            }
+        }
     }
+
+    AssetLoader::instance().shutdown();
 }
 
 void Game::updateWindow() {
@@ -58,4 +201,8 @@ void Game::updateWindow() {
     }
 
     window.setVerticalSyncEnabled(cfg.vsync);
+    window.setView(VirtualCanvas::makeView(window.getSize()));
+    ResolutionScaler::instance().configure(cfg);
+    Input::instance().syncPointer(window);
+    sceneManager.invalidateLayout();
 }
\ No newline at end of file
@@ -12,4 +12,5 @@ private:
     sf::RenderWindow window;
     SceneManager sceneManager;  
     GameConfig cfg;
+    bool focused = true;
 };
@@ -1,9 +1,155 @@
 ﻿#include "GlitchRenderer.h"
-#include <random>
+#include "Rng.h"
+#include "RenderQueue.h"
+#include "ResolutionScaler.h"
+#include "VirtualCanvas.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <cstdlib>
 #include <cstdint>
 
+namespace {
+    bool timersPaused = false;
+    float interpolationAlpha = 1.f;
+
+    // Номер отрисованного кадра; растет в endFrame(), а не в update(), которых за кадр бывает от 0 до 8
+    std::uint64_t renderedFrames = 0;
+
+    // F4 переключает шейдерный путь сразу для всех сцен
+    bool shaderEnabled = true;
+
+    // Тряска кадра для постобработки; ее оставляет renderBackground() сцены, сбрасывает endFrame()
+    struct PostProcessParams {
+        sf::Vector2f offset;          // в пикселях окна
+        float splitStrength = 0.f;
+    };
+    PostProcessParams framePostProcess;
+
+    // Фон рисуется в пикселях окна; вид сцены (виртуальный холст) возвращается на выходе
+    struct PixelViewScope {
+        sf::RenderTarget& target;
+        sf::View saved;
+
+        PixelViewScope(sf::RenderTarget& target, sf::Vector2u size) : target(target), saved(target.getView()) {
+            target.setView(sf::View(sf::FloatRect({ 0.f, 0.f }, sf::Vector2f(size))));
+        }
+        ~PixelViewScope() { target.setView(saved); }
+    };
+
+    // Общий поток всех GlitchRenderer: при одном seed последовательность глитчей повторяется.
+    // Из него читает только update() с фиксированным шагом
+    RngStream& glitchRng() {
+        return Rng::instance().stream(RngStreamId::Glitch);
+    }
+
+    // Для render(): линии, квадраты, наведение, смещения текста и seed шейдера
+    RngStream& visualRng() {
+        return Rng::instance().stream(RngStreamId::GlitchVisual);
+    }
+
+    // Постобработка собранного кадра сцены одним проходом: сдвиг, RGB-разделение вместо призрачных
+    // спрайтов и дрожание строк развертки. GLSL 1.10 без циклов и производных — работает и на Mesa llvmpipe
+    const char* GLITCH_FRAGMENT_SHADER = R"(#version 110
+uniform sampler2D texture;
+uniform vec2 offset;
+uniform float splitStrength;
+uniform float jitter;
+uniform float lineCount;
+uniform float seed;
+
+float hash(float n) {
+    return fract(sin(n) * 43758.5453);
+}
+
+void main() {
+    vec2 uv = gl_TexCoord[0].xy;
+
+    float line = floor(uv.y * lineCount);
+    uv.x += (hash(line + seed) - 0.5) * jitter;
+
+    vec4 base = texture2D(texture, uv - offset);
+    vec3 redGhost = texture2D(texture, uv + offset * 0.3).rgb * vec3(1.0, 0.39, 0.39);
+    vec3 greenGhost = texture2D(texture, uv - offset * 0.5).rgb * vec3(0.39, 1.0, 0.39);
+
+    vec3 color = mix(base.rgb, redGhost, 0.31 * splitStrength);
+    color = mix(color, greenGhost, 0.24 * splitStrength);
+    gl_FragColor = vec4(color, 1.0) * gl_Color;
+}
+)";
+
+    // Шейдер общий для всех сцен; компилируется при первом использовании, когда уже есть контекст.
+    // nullptr — шейдеры недоступны или не собрались, тогда работает путь на спрайтах
+    sf::Shader* glitchShader() {
+        static sf::Shader shader;
+        static const bool ready = [] {
+            if (!sf::Shader::isAvailable()) {
+                std::cout << "GlitchRenderer: shaders unavailable, using sprite fallback" << std::endl;
+                return false;
+            }
+            if (!shader.loadFromMemory(GLITCH_FRAGMENT_SHADER, sf::Shader::Type::Fragment)) {
+                std::cerr << "GlitchRenderer: glitch shader failed to compile, using sprite fallback" << std::endl;
+                return false;
+            }
+            shader.setUniform("texture", sf::Shader::CurrentTexture);
+            return true;
+        }();
+        return ready ? &shader : nullptr;
+    }
+
+    // Пресеты эмиттеров фрагментов
+    ParticleEmitterDesc fragmentStreamPreset() {
+        ParticleEmitterDesc desc;
+        desc.kind = ParticleEmitterDesc::Kind::Stream;
+        desc.rate = 40.f;
+        desc.minLifetime = 0.4f;
+        desc.maxLifetime = 1.5f;
+        desc.minSpeed = 15.f;
+        desc.maxSpeed = 80.f;
+        desc.direction = { 1.f, 0.f };
+        desc.spread = 0.4f;
+        desc.minSize = 3.f;
+        desc.maxSize = 14.f;
+        desc.palette = {
+            sf::Color(255, 0, 255, 180),
+            sf::Color(0, 255, 255, 180),
+            sf::Color(255, 255, 0, 180),
+            sf::Color(255, 0, 0, 180),
+        };
+        return desc;
+    }
+
+    ParticleEmitterDesc hoverSparksPreset() {
+        ParticleEmitterDesc desc;
+        desc.kind = ParticleEmitterDesc::Kind::Hover;
+        desc.rate = 240.f;
+        desc.minLifetime = 0.15f;
+        desc.maxLifetime = 0.45f;
+        desc.minSpeed = 60.f;
+        desc.maxSpeed = 220.f;
+        desc.direction = { 1.f, 0.f };
+        desc.spread = 0.5f;
+        desc.minSize = 1.f;
+        desc.maxSize = 4.f;
+        desc.palette = { sf::Color(255, 0, 0, 220), sf::Color(139, 0, 0, 220), sf::Color(255, 255, 255, 200) };
+        return desc;
+    }
+
+    ParticleEmitterDesc clickBurstPreset() {
+        ParticleEmitterDesc desc;
+        desc.kind = ParticleEmitterDesc::Kind::Burst;
+        desc.burstCount = 600;
+        desc.minLifetime = 0.2f;
+        desc.maxLifetime = 0.7f;
+        desc.minSpeed = 80.f;
+        desc.maxSpeed = 420.f;
+        desc.minSize = 1.f;
+        desc.maxSize = 5.f;
+        desc.palette = { sf::Color(255, 0, 0, 230), sf::Color(255, 0, 255, 200), sf::Color(255, 255, 255, 200) };
+        return desc;
+    }
+}
+
 GlitchRenderer::GlitchRenderer() {
     originalBackgroundPos = sf::Vector2f(0.f, 0.f);
 
@@ -16,35 +162,51 @@ GlitchRenderer::GlitchRenderer() {
     analogOffsetX = 0.f;
     analogOffsetY = 0.f;
     analogTimer = 0.f;
+
+    // Типичный кадр: 15 линий, 8 квадратов и полоса наведения
+    overlayVertices.resize(32 * 6);
+
+    fragmentEmitter = particles.addEmitter(fragmentStreamPreset());
+    hoverEmitter = particles.addEmitter(hoverSparksPreset());
+    burstEmitter = particles.addEmitter(clickBurstPreset());
+    randomBatch.reserve(64);
 }
 
 void GlitchRenderer::update(float deltaTime) {
+    if (timersPaused) return;
+
+    // Положение тряски на прошлом шаге — от него render() интерполирует к текущему
+    prevAnalogOffsetX = analogOffsetX;
+    prevAnalogOffsetY = analogOffsetY;
+
+    particles.update(deltaTime);
+
     // Обновляем таймер для фона
     backgroundGlitchTimer += deltaTime;
     if (backgroundGlitchTimer > 0.8f) {
-        backgroundGlitchActive = (rand() % 2 == 0); // 50% шанс
+        backgroundGlitchActive = backgroundGlitchEnabled && glitchRng().chance(0.5f); // 50% шанс
         backgroundGlitchTimer = 0.f;
     }
 
     // Обновляем таймер для текста
     textGlitchTimer += deltaTime;
     if (textGlitchTimer > 1.0f) {
-        textGlitchActive = (rand() % 2 == 0); // 50% шанс
+        textGlitchActive = glitchRng().chance(0.5f); // 50% шанс
         textGlitchTimer = 0.f;
     }
 
     // Обновляем таймер для киберпанк квадратов
     squareGlitchTimer += deltaTime;
-    if (squareGlitchTimer > 0.1f + (rand() % 200) / 1000.0f) { // Случайная частота 0.1-0.3 секунды
+    if (squareGlitchTimer > 0.1f + glitchRng().nextInt(200) / 1000.0f) { // Случайная частота 0.1-0.3 секунды
         squareGlitchTimer = 0.f;
     }
 
     // Обновляем аналоговый глитч (более натуральная тряска)
     analogTimer += deltaTime;
     if (analogTimer > 0.05f) { // Обновляем каждые 50мс для плавности
-        if (analogGlitchEnabled && (rand() % 4 == 0)) { // 25% шанс сработать
-            analogOffsetX = getRandomOffset(backgroundIntensity * 12.0f);
-            analogOffsetY = getRandomOffset(backgroundIntensity * 3.0f); // Меньше по Y для реалистичности
+        if (analogGlitchEnabled && glitchRng().chance(0.25f)) { // 25% шанс сработать
+            analogOffsetX = getRandomOffset(glitchRng(), backgroundIntensity * 12.0f);
+            analogOffsetY = getRandomOffset(glitchRng(), backgroundIntensity * 3.0f); // Меньше по Y для реалистичности
         }
         else {
             analogOffsetX *= 0.8f; // Плавное затухание
@@ -54,98 +216,253 @@ void GlitchRenderer::update(float deltaTime) {
     }
 }
 
-void GlitchRenderer::renderBackground(sf::RenderWindow& window, sf::Texture& texture) {
-    sf::Sprite backgroundSprite(texture);
-    auto windowSize = window.getSize();
-    auto textureSize = texture.getSize();
-
-    // Масштабирование
-    float scaleX = static_cast<float>(windowSize.x) / textureSize.x;
-    float scaleY = static_cast<float>(windowSize.y) / textureSize.y;
-    float scale = std::max(scaleX, scaleY);
+void GlitchRenderer::renderBackground(sf::RenderTarget& target, sf::Texture& texture) {
+    beginStatsFrame();
+    auto targetSize = target.getSize();
+    if (targetSize.x == 0 || targetSize.y == 0 || texture.getSize().x == 0) return;
+
+    // Цель может быть уменьшенным кадром ResolutionScaler; смещения заданы в пикселях окна
+    float scale = ResolutionScaler::instance().isComposing() ? ResolutionScaler::instance().getScale() : 1.f;
+    frameStats.renderScale = scale;
+    frameStats.screenPixels = static_cast<double>(targetSize.x) * targetSize.y;
+    PixelViewScope pixelView(target, targetSize);
+    drawBackgroundLayer(target, targetSize, texture, scale);
+}
 
-    backgroundSprite.setScale(sf::Vector2f(scaleX, scaleY));
+void GlitchRenderer::drawBackgroundLayer(sf::RenderTarget& target, sf::Vector2u size, const sf::Texture& texture, float pixelScale) {
+    sf::Vector2f screen(size);
+    double layerPixels = static_cast<double>(screen.x) * screen.y;
 
-    // Применяем аналоговый глитч (более натуральный)
+    // Смещение основного слоя (в пикселях окна, в слой переводится через pixelScale)
+    sf::Vector2f offset = originalBackgroundPos;
     if (analogGlitchEnabled) {
-        backgroundSprite.setPosition(sf::Vector2f(analogOffsetX, analogOffsetY));
+        offset = getAnalogOffset();
+    }
+    // Старый глич эффект (оставляем для совместимости)
+    else if (backgroundGlitchActive) {
+        offset = sf::Vector2f(getRandomOffset(visualRng(), backgroundIntensity * 8.0f), getRandomOffset(visualRng(), backgroundIntensity * 8.0f));
+    }
 
-        // Создаем "след" от старого изображения с другим цветом
-        sf::Sprite ghostSprite = backgroundSprite;
-        ghostSprite.setPosition(sf::Vector2f(-analogOffsetX * 0.3f, -analogOffsetY * 0.3f));
-        ghostSprite.setColor(sf::Color(255, 100, 100, 80)); // Красноватый призрачный след
-        window.draw(ghostSprite);
+    const sf::Texture* baked = bakeBackground(texture, size, backgroundDarkeningEnabled ? darkeningIntensity : 0.f);
+    if (baked && isShaderActive() && ResolutionScaler::instance().isComposing()) {
+        // Сдвиг и RGB-разделение делает постобработка всего кадра в ResolutionScaler::present();
+        // фон здесь — один запеченный спрайт на месте
+        framePostProcess.offset = offset;
+        framePostProcess.splitStrength = analogGlitchEnabled ? 1.f : 0.f;
+
+        target.draw(sf::Sprite(*baked));
+        frameStats.drawCalls++;
+        frameStats.filledPixels += layerPixels;
+        frameStats.shaderPasses++;
+        return;
+    }
+    offset *= pixelScale;
+
+    if (!baked) {
+        // Без RenderTexture рисуем по-старому: масштабированный спрайт и затемнение поверх
+        sf::Sprite backgroundSprite(texture);
+        backgroundSprite.setScale(sf::Vector2f(screen.x / texture.getSize().x, screen.y / texture.getSize().y));
+        backgroundSprite.setPosition(offset);
+        target.draw(backgroundSprite);
+        frameStats.drawCalls++;
+        frameStats.filledPixels += layerPixels;
+
+        if (backgroundDarkeningEnabled) {
+            sf::RectangleShape darkOverlay(screen);
+            darkOverlay.setFillColor(sf::Color(0, 0, 0, static_cast<std::uint8_t>(255 * darkeningIntensity)));
+            target.draw(darkOverlay);
+            frameStats.drawCalls++;
+            frameStats.filledPixels += layerPixels;
+        }
+        return;
+    }
 
-        // Еще один слой для усиления эффекта
-        sf::Sprite ghostSprite2 = backgroundSprite;
-        ghostSprite2.setPosition(sf::Vector2f(analogOffsetX * 0.5f, analogOffsetY * 0.5f));
-        ghostSprite2.setColor(sf::Color(100, 255, 100, 60)); // Зеленоватый след
-        window.draw(ghostSprite2);
+    // Масштабированный и затемненный фон уже запечен — одна заливка экрана
+    sf::Sprite backgroundSprite(*baked);
+    backgroundSprite.setPosition(offset);
+    target.draw(backgroundSprite);
+    frameStats.drawCalls++;
+    frameStats.filledPixels += layerPixels;
+
+    // Непрозрачный основной слой перекрывает призрачные следы везде, кроме полос,
+    // открытых сдвигом. Рисуем слои только в этих полосах
+    sf::Vector2i shift(static_cast<int>(std::lround(offset.x)), static_cast<int>(std::lround(offset.y)));
+    if (shift.x == 0 && shift.y == 0) return;
+
+    sf::Vector2i area(size);
+    sf::IntRect strips[2];
+    int stripCount = 0;
+    if (shift.y != 0) {
+        int height = std::min(std::abs(shift.y), area.y);
+        strips[stripCount++] = sf::IntRect({ 0, shift.y > 0 ? 0 : area.y - height }, { area.x, height });
     }
-    // Старый глитч эффект (оставляем для совместимости)
-    else if (backgroundGlitchActive) {
-        float offsetX = getRandomOffset(backgroundIntensity * 8.0f);
-        float offsetY = getRandomOffset(backgroundIntensity * 8.0f);
-        backgroundSprite.setPosition(sf::Vector2f(offsetX, offsetY));
+    if (shift.x != 0) {
+        // Углы уже закрыты горизонтальной полосой
+        int width = std::min(std::abs(shift.x), area.x);
+        int top = std::max(shift.y, 0);
+        int height = area.y - std::abs(shift.y);
+        if (height > 0) {
+            strips[stripCount++] = sf::IntRect({ shift.x > 0 ? 0 : area.x - width, top }, { width, height });
+        }
     }
-    else {
-        backgroundSprite.setPosition(originalBackgroundPos);
+
+    struct Layer {
+        sf::Vector2f offset;
+        sf::Color color;
+    };
+    // Снизу вверх: несдвинутый фон сцены, красноватый и зеленоватый следы
+    Layer layers[3] = {
+        { { 0.f, 0.f }, sf::Color::White },
+        { { -offset.x * 0.3f, -offset.y * 0.3f }, sf::Color(255, 100, 100, 80) },
+        { { offset.x * 0.5f, offset.y * 0.5f }, sf::Color(100, 255, 100, 60) },
+    };
+    int layerCount = analogGlitchEnabled ? 3 : 1;
+
+    for (int s = 0; s < stripCount; ++s) {
+        for (int l = 0; l < layerCount; ++l) {
+            sf::Vector2i source = strips[s].position - sf::Vector2i(static_cast<int>(std::lround(layers[l].offset.x)), static_cast<int>(std::lround(layers[l].offset.y)));
+            sf::Sprite strip(*baked, sf::IntRect(source, strips[s].size));
+            strip.setPosition(sf::Vector2f(strips[s].position));
+            strip.setColor(layers[l].color);
+            target.draw(strip);
+            frameStats.drawCalls++;
+            frameStats.filledPixels += static_cast<double>(strips[s].size.x) * strips[s].size.y;
+        }
     }
+}
 
-    window.draw(backgroundSprite);
+const sf::Texture* GlitchRenderer::bakeBackground(const sf::Texture& texture, sf::Vector2u size, float darkening) {
+    if (bakedBackground && bakedSource == &texture && bakedSourceSize == texture.getSize()
+        && bakedBackground->getSize() == size && bakedDarkening == darkening) {
+        return &bakedBackground->getTexture();
+    }
+
+    if (!bakedBackground) {
+        bakedBackground = std::make_unique<sf::RenderTexture>();
+    }
+    if (bakedBackground->getSize() != size && !bakedBackground->resize(size)) {
+        std::cerr << "GlitchRenderer: could not create " << size.x << "x" << size.y << " background layer" << std::endl;
+        bakedBackground.reset();
+        return nullptr;
+    }
 
-    // Применяем затемнение фона
-    if (backgroundDarkeningEnabled) {
-        sf::RectangleShape darkOverlay(sf::Vector2f(windowSize.x, windowSize.y));
-        darkOverlay.setFillColor(sf::Color(0, 0, 0, static_cast<std::uint8_t>(255 * darkeningIntensity)));
-        window.draw(darkOverlay);
+    // Масштаб и затемнение применяются один раз на разрешение, а не каждый кадр
+    sf::Vector2f screen(size);
+    sf::Sprite sprite(texture);
+    sprite.setScale(sf::Vector2f(screen.x / texture.getSize().x, screen.y / texture.getSize().y));
+    bakedBackground->clear(sf::Color::Black);
+    bakedBackground->draw(sprite);
+    if (darkening > 0.f) {
+        sf::RectangleShape darkOverlay(screen);
+        darkOverlay.setFillColor(sf::Color(0, 0, 0, static_cast<std::uint8_t>(255 * darkening)));
+        bakedBackground->draw(darkOverlay);
     }
+    bakedBackground->display();
+
+    bakedSource = &texture;
+    bakedSourceSize = texture.getSize();
+    bakedDarkening = darkening;
+    // Перезапекания видны в статистике F3 (background bakes), в консоль не пишем
+    frameStats.backgroundBakes++;
+    return &bakedBackground->getTexture();
+}
+
+void GlitchRenderer::setShaderEnabled(bool enabled) {
+    shaderEnabled = enabled;
+}
+
+bool GlitchRenderer::isShaderActive() {
+    return shaderEnabled && glitchShader() != nullptr;
+}
+
+sf::Shader* GlitchRenderer::preparePostProcess(sf::Vector2u windowSize) {
+    sf::Shader* shader = isShaderActive() ? glitchShader() : nullptr;
+    if (!shader || windowSize.x == 0 || windowSize.y == 0) return nullptr;
+
+    sf::Vector2f screen(windowSize);
+    sf::Vector2f offset = framePostProcess.offset;
+
+    // Кадр сцены — текстура RenderTexture, она лежит в памяти перевернутой: gl_TexCoord.y
+    // растет вверх по экрану, поэтому сдвиг вниз на экране — это минус по y в текстуре
+    shader->setUniform("offset", sf::Vector2f(offset.x / screen.x, -offset.y / screen.y));
+    shader->setUniform("splitStrength", framePostProcess.splitStrength);
+    // Дрожание пропорционально текущей тряске и затухает вместе с ней
+    shader->setUniform("jitter", framePostProcess.splitStrength * std::abs(offset.x) * 0.25f / screen.x);
+    // Строка развертки — два пикселя окна при любой доле разрешения кадра
+    shader->setUniform("lineCount", screen.y / 2.f);
+    shader->setUniform("seed", static_cast<float>(visualRng().nextInt(1000)));
+    return shader;
 }
 
 void GlitchRenderer::setBackgroundGlitch(bool enabled, float intensity) {
+    backgroundGlitchEnabled = enabled;
     backgroundGlitchActive = enabled;
     backgroundIntensity = intensity;
 }
 
-void GlitchRenderer::renderGlitchText(sf::RenderWindow& window, sf::Text& mainText, const std::string& text) {
-    // Создаем глич-версию текста если нужно
-    if (!glitchText || currentFont != &mainText.getFont()) {
-        currentFont = const_cast<sf::Font*>(&mainText.getFont());
-        glitchText = std::make_unique<sf::Text>(*currentFont);
-        glitchText->setString(text);
-        glitchText->setCharacterSize(mainText.getCharacterSize());
-        glitchText->setFillColor(sf::Color(139, 0, 0));
-    }
+void GlitchRenderer::setPaused(bool paused) {
+    timersPaused = paused;
+}
 
-    auto originalPos = mainText.getPosition();
+bool GlitchRenderer::isPaused() {
+    return timersPaused;
+}
 
-    // Применяем аналоговый глитч к тексту (текст "едет" вместе с фоном)
-    if (analogGlitchEnabled) {
-        // Основной текст смещается вместе с фоном
-        mainText.setPosition(sf::Vector2f(originalPos.x + analogOffsetX, originalPos.y + analogOffsetY));
+bool GlitchRenderer::isAnimating() const {
+    return backgroundGlitchEnabled || analogGlitchEnabled || cyberpunkSquaresEnabled
+        || particles.getCount() > 0;
+}
 
-        // Призрачные следы текста остаются на старых позициях
-        sf::Text ghostText1 = mainText;
-        ghostText1.setPosition(originalPos);
-        ghostText1.setFillColor(sf::Color(255, 100, 100, 120));
-        window.draw(ghostText1);
+void GlitchRenderer::renderGlitchText(sf::RenderTarget& target, SdfText& mainText) {
+    beginStatsFrame();
+    // SdfText уже хранит свою геометрию; призраки — ее копии со сдвигом и цветом в общем пакете очереди
+    auto originalPos = restoreAnchor(mainText);
+
+    if (analogGlitchEnabled) {
+        sf::Vector2f analog = getAnalogOffset();
+        submitTextGhost(target, mainText, { 0.f, 0.f }, sf::Color(255, 100, 100, 120));
+        submitTextGhost(target, mainText, -analog * 0.2f, sf::Color(100, 255, 100, 100));
 
-        sf::Text ghostText2 = mainText;
-        ghostText2.setPosition(sf::Vector2f(originalPos.x - analogOffsetX * 0.2f, originalPos.y - analogOffsetY * 0.2f));
-        ghostText2.setFillColor(sf::Color(100, 255, 100, 100));
-        window.draw(ghostText2);
+        // Основной текст смещается вместе с фоном
+        placeText(mainText, originalPos + analog);
     }
-    // Старый глитч эффект для текста
     else if (textGlitchActive) {
-        float offsetX = getRandomOffset(textIntensity * 5.0f);
-        float offsetY = getRandomOffset(textIntensity * 5.0f);
+        float offsetX = getRandomOffset(visualRng(), textIntensity * 5.0f);
+        float offsetY = getRandomOffset(visualRng(), textIntensity * 5.0f);
+
+        submitTextGhost(target, mainText, { -offsetX + 2.0f, -offsetY + 2.0f }, sf::Color(139, 0, 0));
 
-        mainText.setPosition(sf::Vector2f(originalPos.x + offsetX, originalPos.y + offsetY));
+        placeText(mainText, sf::Vector2f(originalPos.x + offsetX, originalPos.y + offsetY));
+    }
+}
 
-        // Рендерим глич-версию со смещением
-        glitchText->setPosition(sf::Vector2f(originalPos.x - offsetX + 2.0f, originalPos.y - offsetY + 2.0f));
-        window.draw(*glitchText);
+sf::Vector2f GlitchRenderer::restoreAnchor(sf::Transformable& text) {
+    // Текст сдвигается на кадр, а раскладка сцены ставит его только при изменении окна.
+    // Если позиция не та, что мы ставили, ее задала сцена — это новая опорная точка
+    auto it = textAnchors.find(&text);
+    if (it == textAnchors.end()) {
+        it = textAnchors.emplace(&text, TextAnchor{ text.getPosition(), text.getPosition() }).first;
     }
+    else if (text.getPosition() != it->second.placed) {
+        it->second.anchor = text.getPosition();
+    }
+
+    text.setPosition(it->second.anchor);
+    it->second.placed = it->second.anchor;
+    return it->second.anchor;
+}
+
+void GlitchRenderer::placeText(sf::Transformable& text, sf::Vector2f position) {
+    text.setPosition(position);
+    textAnchors[&text].placed = position;
+}
+
+void GlitchRenderer::submitTextGhost(sf::RenderTarget& target, const SdfText& text, sf::Vector2f offset, sf::Color color) {
+    // Вершины призрака идут в тот же пакет, что и подписи этого размера; без атласа — отдельный вызов
+    if (RenderQueue::instance().submitGhost(text, offset, color, RenderQueue::LAYER_TEXT)) return;
+
+    text.drawGhost(target, offset, color);
+    frameStats.drawCalls++;
 }
 
 void GlitchRenderer::setTextGlitch(bool enabled, float intensity) {
@@ -153,52 +470,140 @@ void GlitchRenderer::setTextGlitch(bool enabled, float intensity) {
     textIntensity = intensity;
 }
 
-void GlitchRenderer::renderGlitchLines(sf::RenderWindow& window, int lineCount) {
+void GlitchRenderer::renderGlitchLines(sf::RenderTarget& target, int lineCount) {
+    beginStatsFrame();
     if (!screenGlitchEnabled) return;
 
-    sf::VertexArray lines(sf::PrimitiveType::Lines);
-    auto windowSize = window.getSize();
+    auto windowSize = target.getSize();
+    if (windowSize.y == 0) return;
+    frameStats.overlaySubmissions++;
 
-    for (int i = 0; i < lineCount; ++i) {
-        int y = rand() % windowSize.y;
-        sf::Color glitchColor = getGlitchColor();
-
-        sf::Vertex v1;
-        v1.position = sf::Vector2f(0.f, static_cast<float>(y));
-        v1.color = glitchColor;
+    // Линии по всей видимой области вида сцены, толщиной и шагом в один пиксель окна
+    sf::FloatRect area = VirtualCanvas::getVisibleArea(target);
+    float pixel = area.size.y / static_cast<float>(windowSize.y);
 
-        sf::Vertex v2;
-        v2.position = sf::Vector2f(static_cast<float>(windowSize.x), static_cast<float>(y));
-        v2.color = glitchColor;
+    // Все случайные числа кадра одним пакетом: позиция и яркость на линию
+    randomBatch.resize(static_cast<std::size_t>(std::max(lineCount, 0)) * 2);
+    visualRng().fill(randomBatch.data(), randomBatch.size());
 
-        lines.append(v1);
-        lines.append(v2);
+    // Линии толщиной в пиксель — тоже квады, чтобы весь оверлей был одного типа примитивов
+    for (int i = 0; i < lineCount; ++i) {
+        std::uint32_t y = RngStream::bounded(randomBatch[i * 2], windowSize.y);
+        std::uint8_t brightness = static_cast<std::uint8_t>(100 + RngStream::bounded(randomBatch[i * 2 + 1], 155));
+        appendOverlayQuad(area.position.x, area.position.y + y * pixel, area.size.x, pixel, sf::Color(brightness, 0, 0));
     }
-
-    window.draw(lines);
 }
 
 void GlitchRenderer::setScreenGlitch(bool enabled) {
     screenGlitchEnabled = enabled;
 }
 
-void GlitchRenderer::renderHoverGlitch(sf::RenderWindow& window, const sf::FloatRect& bounds) {
+void GlitchRenderer::renderHoverGlitch(sf::RenderTarget& target, const sf::FloatRect& bounds) {
+    beginStatsFrame();
     float x = bounds.position.x;
     float y = bounds.position.y;
     float w = bounds.size.x;
     float h = bounds.size.y;
 
-    sf::RectangleShape glitch(sf::Vector2f(
-        w * (0.3f + 0.2f * (rand() % 3)),
-        2.f
-    ));
-    glitch.setFillColor(sf::Color::Red);
-    glitch.setPosition(sf::Vector2f(
-        x + static_cast<float>(rand() % static_cast<int>(w / 2)),
-        y + 5.f + static_cast<float>(rand() % static_cast<int>(h - 10.f))
-    ));
+    auto& rng = visualRng();
+    // Искры летят из области наведения, пока она подтверждается каждый кадр
+    particles.setEmitterArea(hoverEmitter, bounds);
 
-    window.draw(glitch);
+    float width = w * (0.3f + 0.2f * rng.nextInt(3));
+    float offsetX = static_cast<float>(rng.nextInt(static_cast<int>(w / 2)));
+    float offsetY = 5.f + static_cast<float>(rng.nextInt(static_cast<int>(h - 10.f)));
+
+    frameStats.overlaySubmissions++;
+    appendOverlayQuad(x + offsetX, y + offsetY, width, 2.f, sf::Color::Red);
+}
+
+void GlitchRenderer::appendOverlayQuad(float x, float y, float width, float height, sf::Color color) {
+    sf::Vector2f topLeft(x, y);
+    sf::Vector2f topRight(x + width, y);
+    sf::Vector2f bottomLeft(x, y + height);
+    sf::Vector2f bottomRight(x + width, y + height);
+
+    sf::Vertex* v = allocateOverlay(6);
+    v[0] = { topLeft, color };
+    v[1] = { topRight, color };
+    v[2] = { bottomLeft, color };
+    v[3] = { bottomLeft, color };
+    v[4] = { topRight, color };
+    v[5] = { bottomRight, color };
+    frameStats.overlayQuads++;
+    frameStats.filledPixels += static_cast<double>(width) * height;
+}
+
+sf::Vertex* GlitchRenderer::allocateOverlay(std::size_t vertexCount) {
+    // Вектор только растет; вершины перезаписываются на месте, без повторной инициализации каждый кадр
+    std::size_t first = overlayCount;
+    overlayCount += vertexCount;
+    if (overlayVertices.size() < overlayCount) {
+        overlayVertices.resize(std::max(overlayCount, overlayVertices.size() * 2));
+    }
+    return overlayVertices.data() + first;
+}
+
+void GlitchRenderer::flushOverlay(sf::RenderTarget& target) {
+    beginStatsFrame();
+    // Фрагменты частиц идут в тот же пакет, поверх линий и квадратов
+    if (std::size_t particleVertices = particles.getVertexCount()) {
+        particles.writeQuads(allocateOverlay(particleVertices));
+        frameStats.particles = particles.getCount();
+    }
+
+    if (overlayCount == 0) return;
+
+    std::size_t count = overlayCount;
+    if (sf::VertexBuffer::isAvailable()) {
+        // GPU-буфер растет только вверх, поэтому в установившемся режиме не пересоздается
+        bool ready = overlayBuffer.getVertexCount() >= count;
+        if (!ready) {
+            ready = overlayBuffer.create(std::max(count, overlayBuffer.getVertexCount() * 2));
+        }
+        if (ready && overlayBuffer.update(overlayVertices.data(), count, 0)) {
+            target.draw(overlayBuffer, 0, count);
+        }
+        else {
+            target.draw(overlayVertices.data(), count, sf::PrimitiveType::Triangles);
+        }
+    }
+    else {
+        target.draw(overlayVertices.data(), count, sf::PrimitiveType::Triangles);
+    }
+
+    overlayCount = 0;
+    frameStats.drawCalls++;
+    frameStats.overlayFlushes++;
+}
+
+void GlitchRenderer::endFrame() {
+    renderedFrames++;
+    framePostProcess = PostProcessParams();
+}
+
+void GlitchRenderer::beginStatsFrame() {
+    // Первый вызов отрисовки в новом кадре закрывает счетчики предыдущего
+    if (statsFrame == renderedFrames) return;
+
+    lastFrameStats = frameStats;
+    frameStats = Stats();
+    statsFrame = renderedFrames;
+}
+
+const GlitchRenderer::Stats& GlitchRenderer::getLastFrameStats() const {
+    // Кадр, в котором рендерер рисовал последним, уже закрыт endFrame(): его счетчики еще в frameStats
+    return statsFrame < renderedFrames ? frameStats : lastFrameStats;
+}
+
+void GlitchRenderer::printStats() const {
+    const Stats& stats = getLastFrameStats();
+    std::cout << "GlitchRenderer: " << stats.drawCalls << " draw calls last frame, overlay "
+        << stats.overlayQuads << " quads from " << stats.overlaySubmissions
+        << " submissions in " << stats.overlayFlushes << " flush(es), overdraw "
+        << stats.getOverdraw() << " screens, background bakes " << stats.backgroundBakes
+        << ", shader passes " << stats.shaderPasses << ", particles " << stats.particles
+        << ", render scale " << stats.renderScale << std::endl;
 }
 
 // Новые функции
@@ -210,6 +615,12 @@ void GlitchRenderer::setBackgroundDarkening(bool enabled, float intensity) {
 
 void GlitchRenderer::setCyberpunkSquares(bool enabled) {
     cyberpunkSquaresEnabled = enabled;
+    particles.setEmitterActive(fragmentEmitter, enabled);
+}
+
+void GlitchRenderer::emitBurst(const sf::FloatRect& area) {
+    particles.setEmitterArea(burstEmitter, area);
+    particles.burst(burstEmitter);
 }
 
 void GlitchRenderer::setAnalogGlitch(bool enabled) {
@@ -217,25 +628,48 @@ void GlitchRenderer::setAnalogGlitch(bool enabled) {
     if (!enabled) {
         analogOffsetX = 0.f;
         analogOffsetY = 0.f;
+        prevAnalogOffsetX = 0.f;
+        prevAnalogOffsetY = 0.f;
     }
 }
 
-void GlitchRenderer::renderCyberpunkSquares(sf::RenderWindow& window, int squareCount) {
+void GlitchRenderer::setInterpolationAlpha(float alpha) {
+    interpolationAlpha = std::clamp(alpha, 0.f, 1.f);
+}
+
+sf::Vector2f GlitchRenderer::getAnalogOffset() const {
+    return sf::Vector2f(
+        prevAnalogOffsetX + (analogOffsetX - prevAnalogOffsetX) * interpolationAlpha,
+        prevAnalogOffsetY + (analogOffsetY - prevAnalogOffsetY) * interpolationAlpha);
+}
+
+void GlitchRenderer::renderCyberpunkSquares(sf::RenderTarget& target, int squareCount) {
+    beginStatsFrame();
     if (!cyberpunkSquaresEnabled) return;
 
-    auto windowSize = window.getSize();
+    // Координаты оверлея — в виде сцены, поэтому берем видимую область, а не размер окна
+    sf::FloatRect area = VirtualCanvas::getVisibleArea(target);
+
+    // Дрейфующие фрагменты рождаются по всему экрану и живут дольше мелькающих квадратов
+    particles.setEmitterArea(fragmentEmitter, area);
 
     // Рендерим только если прошло достаточно времени (создает эффект мелькания)
     if (squareGlitchTimer < 0.03f) { // Квадраты видны только 30мс
+        frameStats.overlaySubmissions += static_cast<std::size_t>(squareCount);
+
+        // Размер, две координаты и цвет на квадрат — одним пакетом
+        randomBatch.resize(static_cast<std::size_t>(std::max(squareCount, 0)) * 4);
+        visualRng().fill(randomBatch.data(), randomBatch.size());
+
         for (int i = 0; i < squareCount; ++i) {
+            const std::uint32_t* raw = &randomBatch[i * 4];
+
             // Случайный размер квадрата
-            float size = 10.f + (rand() % 80);
+            float size = 10.f + RngStream::bounded(raw[0], 80);
 
             // Случайная позиция
-            float x = rand() % static_cast<int>(windowSize.x - size);
-            float y = rand() % static_cast<int>(windowSize.y - size);
-
-            sf::RectangleShape square(sf::Vector2f(size, size));
+            float x = area.position.x + RngStream::bounded(raw[1], static_cast<std::uint32_t>(std::max(0.f, area.size.x - size)));
+            float y = area.position.y + RngStream::bounded(raw[2], static_cast<std::uint32_t>(std::max(0.f, area.size.y - size)));
 
             // Случайный цвет в киберпанк стиле
             sf::Color colors[] = {
@@ -247,19 +681,15 @@ void GlitchRenderer::renderCyberpunkSquares(sf::RenderWindow& window, int square
                 sf::Color(255, 255, 255, 160), // Белый
             };
 
-            square.setFillColor(colors[rand() % 6]);
-            square.setPosition(sf::Vector2f(x, y));
-
-            window.draw(square);
+            appendOverlayQuad(x, y, size, size, colors[RngStream::bounded(raw[3], 6)]);
         }
     }
 }
 
-float GlitchRenderer::getRandomOffset(float intensity) const {
-    return static_cast<float>((rand() % static_cast<int>(intensity * 2)) - intensity);
+float GlitchRenderer::getRandomOffset(RngStream& rng, float intensity) const {
+    return static_cast<float>(rng.nextInt(static_cast<int>(intensity * 2))) - intensity;
 }
 
 sf::Color GlitchRenderer::getGlitchColor() const {
-    int brightness = 100 + (rand() % 155);
-    return sf::Color(brightness, 0, 0);
+    return sf::Color(static_cast<std::uint8_t>(visualRng().range(100, 254)), 0, 0);
 }
\ No newline at end of file
@@ -4,33 +4,92 @@
 #include <optional>
 #include <memory>
 #include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "SdfText.h"
+#include "ParticleSystem.h"
+
+class RngStream;
 
 class GlitchRenderer {
 public:
+    // Счетчики последнего кадра
+    struct Stats {
+        std::size_t drawCalls = 0;          // все draw() рендерера
+        std::size_t overlaySubmissions = 0; // вызовы линий/квадратов/наведения, раньше каждый был отдельным draw
+        std::size_t overlayQuads = 0;
+        std::size_t overlayFlushes = 0;
+        std::size_t backgroundBakes = 0;
+        std::size_t shaderPasses = 0;
+        std::size_t particles = 0;
+        float renderScale = 1.f;            // доля разрешения окна, в которой рисовалась сцена
+        double filledPixels = 0.0;          // площадь фона и оверлея, нарисованная за кадр
+        double screenPixels = 0.0;
+
+        // Сколько полноэкранных заливок эквивалентно нарисованной площади
+        double getOverdraw() const { return screenPixels > 0.0 ? filledPixels / screenPixels : 0.0; }
+    };
+
     GlitchRenderer();
 
     // Обновление эффектов
     void update(float deltaTime);
 
-    // Глич эффекты для фона
-    void renderBackground(sf::RenderWindow& window, sf::Texture& texture);
+    // Общая пауза таймеров и частиц всех рендереров (окно без фокуса)
+    static void setPaused(bool paused);
+    static bool isPaused();
+
+    // Доля кадра между двумя фиксированными шагами update(); тряска рисуется с интерполяцией
+    static void setInterpolationAlpha(float alpha);
+
+    // Закрывает отрисованный кадр для всех рендереров; SceneManager зовет его после render() сцены
+    static void endFrame();
+
+    // Есть ли что-то, что меняет картинку без ввода: тряска, глич-таймеры, квадраты, частицы
+    bool isAnimating() const;
+
+    // Глич эффекты для фона; масштабированный и затемненный фон запекается
+    // в RenderTexture один раз на разрешение, текстуру и степень затемнения
+    void renderBackground(sf::RenderTarget& target, sf::Texture& texture);
     void setBackgroundGlitch(bool enabled, float intensity = 1.0f);
 
-    // Глич эффекты для текста
-    void renderGlitchText(sf::RenderWindow& window, sf::Text& mainText, const std::string& text);
+    // С шейдерами кадр сцены собирается во внутренней цели ResolutionScaler, а сдвиг, RGB-разделение
+    // и дрожание строк делает один проход постобработки при выводе в окно. Без шейдеров
+    // (или после setShaderEnabled(false)) — прежний путь на спрайтах. Переключатель общий для всех сцен
+    static void setShaderEnabled(bool enabled);
+    static bool isShaderActive();
+
+    // Шейдер постобработки с тряской, оставленной renderBackground() в этом кадре; nullptr — шейдерного пути нет
+    static sf::Shader* preparePostProcess(sf::Vector2u windowSize);
+
+    // Глич эффекты для текста: призраки SdfText уходят в RenderQueue на слой текста,
+    // саму надпись нужно отправить после них
+    void renderGlitchText(sf::RenderTarget& target, SdfText& mainText);
     void setTextGlitch(bool enabled, float intensity = 1.0f);
 
+    // Линии, квадраты и полосы наведения только копятся в общий буфер. flushOverlay() рисует
+    // весь оверлей вместе с фрагментами частиц одним вызовом; сцена зовет его в конце своего render()
+    void flushOverlay(sf::RenderTarget& target);
+
+    const Stats& getLastFrameStats() const;
+    void printStats() const;
+
     // Глич линии на экране
-    void renderGlitchLines(sf::RenderWindow& window, int lineCount = 15);
+    void renderGlitchLines(sf::RenderTarget& target, int lineCount = 15);
     void setScreenGlitch(bool enabled);
 
     // Глич эффект при наведении на элемент
-    void renderHoverGlitch(sf::RenderWindow& window, const sf::FloatRect& bounds);
+    void renderHoverGlitch(sf::RenderTarget& target, const sf::FloatRect& bounds);
 
     void setBackgroundDarkening(bool enabled, float intensity = 0.5f);
     void setCyberpunkSquares(bool enabled);
     void setAnalogGlitch(bool enabled);
-    void renderCyberpunkSquares(sf::RenderWindow& window, int squareCount = 5);
+    void renderCyberpunkSquares(sf::RenderTarget& target, int squareCount = 5);
+
+    // Вспышка фрагментов из области (например, по клику на пункт меню)
+    void emitBurst(const sf::FloatRect& area);
 
 private:
     // Таймеры и состояния
@@ -38,19 +97,59 @@ private:
     float textGlitchTimer = 0.f;
     bool backgroundGlitchActive = false;
     bool textGlitchActive = false;
+    bool backgroundGlitchEnabled = true;  // без него таймер больше не включает дрожание фона
     bool screenGlitchEnabled = true;
 
     // Интенсивности эффектов
     float backgroundIntensity = 1.0f;
     float textIntensity = 1.0f;
 
+    // Опорные позиции текста, который глитч сдвигает на кадр
+    struct TextAnchor {
+        sf::Vector2f anchor;
+        sf::Vector2f placed;
+    };
+    std::unordered_map<const sf::Transformable*, TextAnchor> textAnchors;
+
+    sf::Vector2f restoreAnchor(sf::Transformable& text);
+    void placeText(sf::Transformable& text, sf::Vector2f position);
+    void submitTextGhost(sf::RenderTarget& target, const SdfText& text, sf::Vector2f offset, sf::Color color);
+
     // Вспомогательные объекты
-    std::unique_ptr<sf::Text> glitchText;
-    sf::Font* currentFont = nullptr;
     sf::Vector2f originalBackgroundPos;
 
+    // Пакет оверлея: CPU-вершины и постоянный GPU-буфер, оба переиспользуются между кадрами
+    std::vector<sf::Vertex> overlayVertices;
+    std::size_t overlayCount = 0;
+    sf::VertexBuffer overlayBuffer{ sf::PrimitiveType::Triangles, sf::VertexBuffer::Usage::Stream };
+    Stats frameStats;
+    Stats lastFrameStats;
+    std::uint64_t statsFrame = 0;  // кадр, к которому относится frameStats
+    void beginStatsFrame();
+
+    // Буфер для пакетного заполнения из RngStream, емкость сохраняется между кадрами
+    std::vector<std::uint32_t> randomBatch;
+
+    std::unique_ptr<sf::RenderTexture> bakedBackground;
+    const sf::Texture* bakedSource = nullptr;
+    sf::Vector2u bakedSourceSize;
+    float bakedDarkening = -1.f;
+
+    const sf::Texture* bakeBackground(const sf::Texture& texture, sf::Vector2u size, float darkening);
+
+    // Фон в цель размера size; при pixelScale < 1 это уменьшенный кадр ResolutionScaler
+    void drawBackgroundLayer(sf::RenderTarget& target, sf::Vector2u size, const sf::Texture& texture, float pixelScale);
+    // Фрагменты с временем жизни и движением; эмиттеры заданы пресетами в GlitchRenderer.cpp
+    ParticleSystem particles;
+    std::size_t fragmentEmitter = 0;
+    std::size_t hoverEmitter = 0;
+    std::size_t burstEmitter = 0;
+
+    sf::Vertex* allocateOverlay(std::size_t vertexCount);
+    void appendOverlayQuad(float x, float y, float width, float height, sf::Color color);
+
     // Вспомогательные функции
-    float getRandomOffset(float intensity) const;
+    float getRandomOffset(RngStream& rng, float intensity) const;
     sf::Color getGlitchColor() const;
 
     bool backgroundDarkeningEnabled;
@@ -62,5 +161,9 @@ private:
     bool analogGlitchEnabled;
     float analogOffsetX;
     float analogOffsetY;
+    float prevAnalogOffsetX = 0.f;
+    float prevAnalogOffsetY = 0.f;
     float analogTimer;
+
+    sf::Vector2f getAnalogOffset() const;
 };
\ No newline at end of file
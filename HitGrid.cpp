@@ -0,0 +1,63 @@
+﻿#include "HitGrid.h"
+#include "VirtualCanvas.h"
+#include <algorithm>
+#include <cmath>
+
+HitGrid::HitGrid(float cellSize)
+    : cellSize(cellSize),
+    columns(static_cast<int>(std::ceil(VirtualCanvas::WIDTH / cellSize))),
+    rows(static_cast<int>(std::ceil(VirtualCanvas::HEIGHT / cellSize))),
+    cells(static_cast<std::size_t>(columns * rows)) {
+}
+
+void HitGrid::clear() {
+    // Векторы ячеек сохраняют память: пересборка после ресайза ничего не выделяет
+    entries.clear();
+    for (auto& cell : cells) {
+        cell.clear();
+    }
+}
+
+int HitGrid::cellX(float x) const {
+    return std::clamp(static_cast<int>(std::floor(x / cellSize)), 0, columns - 1);
+}
+
+int HitGrid::cellY(float y) const {
+    return std::clamp(static_cast<int>(std::floor(y / cellSize)), 0, rows - 1);
+}
+
+void HitGrid::insert(int id, const sf::FloatRect& bounds) {
+    std::size_t index = entries.size();
+    entries.push_back({ id, bounds });
+
+    int left = cellX(bounds.position.x);
+    int right = cellX(bounds.position.x + bounds.size.x);
+    int top = cellY(bounds.position.y);
+    int bottom = cellY(bounds.position.y + bounds.size.y);
+
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) {
+            cells[static_cast<std::size_t>(y * columns + x)].push_back(index);
+        }
+    }
+}
+
+int HitGrid::hitTest(sf::Vector2f point) const {
+    const auto& cell = cells[static_cast<std::size_t>(cellY(point.y) * columns + cellX(point.x))];
+
+    // С конца: последний вставленный лежит поверх остальных
+    for (auto it = cell.rbegin(); it != cell.rend(); ++it) {
+        const Entry& entry = entries[*it];
+        if (entry.bounds.contains(point)) {
+            return entry.id;
+        }
+    }
+    return -1;
+}
+
+const sf::FloatRect* HitGrid::getBounds(int id) const {
+    for (const auto& entry : entries) {
+        if (entry.id == id) return &entry.bounds;
+    }
+    return nullptr;
+}
@@ -0,0 +1,38 @@
+﻿// HitGrid.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+// Равномерная сетка поверх виртуального холста для поиска элемента под курсором.
+// Сцена заполняет ее закэшированными границами в layout() (и после смены текста),
+// а на MouseMoved проверяет только элементы одной ячейки — цена не зависит от их общего числа.
+// Границы за пределами холста прижимаются к крайним ячейкам, сама проверка всегда точная
+class HitGrid {
+public:
+    explicit HitGrid(float cellSize = 64.f);
+
+    void clear();
+    void insert(int id, const sf::FloatRect& bounds);
+
+    // id элемента под точкой или -1; при перекрытии побеждает вставленный позже (он рисуется выше)
+    int hitTest(sf::Vector2f point) const;
+
+    const sf::FloatRect* getBounds(int id) const;
+    std::size_t size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        int id = -1;
+        sf::FloatRect bounds;
+    };
+
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    float cellSize;
+    int columns;
+    int rows;
+    std::vector<Entry> entries;
+    std::vector<std::vector<std::size_t>> cells;  // индексы entries, по возрастанию
+};
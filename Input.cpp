@@ -0,0 +1,138 @@
+﻿// Input.cpp
+#include "Input.h"
+#include <iostream>
+
+namespace {
+    std::size_t index(Action action) {
+        return static_cast<std::size_t>(action);
+    }
+}
+
+std::optional<sf::Vector2f> InputSnapshot::getPointer(const sf::RenderWindow& window) const {
+    if (!pointerInside) return std::nullopt;
+    return window.mapPixelToCoords(pointer);
+}
+
+Input& Input::instance() {
+    static Input input;
+    return input;
+}
+
+Input::Input() {
+    resetBindings();
+}
+
+void Input::resetBindings() {
+    keyBindings.clear();
+    buttonBindings.clear();
+
+    bind(sf::Keyboard::Scancode::Enter, Action::Confirm);
+    bind(sf::Keyboard::Scancode::NumpadEnter, Action::Confirm);
+    bind(sf::Keyboard::Scancode::Up, Action::Up);
+    bind(sf::Keyboard::Scancode::Down, Action::Down);
+    bind(sf::Keyboard::Scancode::Left, Action::Left);
+    bind(sf::Keyboard::Scancode::Right, Action::Right);
+    bind(sf::Keyboard::Scancode::R, Action::Randomize);
+    bind(sf::Mouse::Button::Left, Action::Select);
+}
+
+void Input::bind(sf::Keyboard::Scancode key, Action action) {
+    keyBindings[static_cast<int>(key)] = action;
+}
+
+void Input::bind(sf::Mouse::Button button, Action action) {
+    buttonBindings[static_cast<int>(button)] = action;
+}
+
+std::optional<Action> Input::findAction(sf::Keyboard::Scancode key) const {
+    auto it = keyBindings.find(static_cast<int>(key));
+    if (it == keyBindings.end()) return std::nullopt;
+    return it->second;
+}
+
+std::optional<Action> Input::findAction(sf::Mouse::Button button) const {
+    auto it = buttonBindings.find(static_cast<int>(button));
+    if (it == buttonBindings.end()) return std::nullopt;
+    return it->second;
+}
+
+std::optional<Action> Input::getAction(const sf::Event& event) const {
+    if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
+        return findAction(key->scancode);
+    }
+    if (const auto* button = event.getIf<sf::Event::MouseButtonPressed>()) {
+        return findAction(button->button);
+    }
+    return std::nullopt;
+}
+
+void Input::syncPointer(const sf::RenderWindow& window) {
+    sf::Vector2i position = sf::Mouse::getPosition(window);
+    sf::Vector2u size = window.getSize();
+
+    current.pointer = position;
+    current.pointerInside = position.x >= 0 && position.y >= 0 &&
+        position.x < static_cast<int>(size.x) && position.y < static_cast<int>(size.y);
+    snapshot.pointer = current.pointer;
+    snapshot.pointerInside = current.pointerInside;
+}
+
+void Input::beginFrame() {
+    // Позиция курсора переходит в следующий кадр, нажатия — нет
+    current.actionsPressed.reset();
+}
+
+void Input::press(std::optional<Action> action) {
+    if (!action) return;
+    current.actionsPressed.set(index(*action));
+}
+
+bool Input::process(const sf::Event& event) {
+    stats.received++;
+
+    if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+        current.pointer = moved->position;
+        current.pointerInside = true;
+        // Новое движение заменяет придержанное: до сцены дойдет только последнее
+        pendingMove = event;
+        return false;
+    }
+    if (event.is<sf::Event::MouseMovedRaw>()) {
+        // Сырые дельты сценам не нужны
+        return false;
+    }
+
+    if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
+        press(findAction(key->scancode));
+    }
+    else if (const auto* button = event.getIf<sf::Event::MouseButtonPressed>()) {
+        current.pointer = button->position;
+        press(findAction(button->button));
+    }
+    else if (event.is<sf::Event::MouseLeft>()) {
+        current.pointerInside = false;
+    }
+    else if (event.is<sf::Event::MouseEntered>()) {
+        current.pointerInside = true;
+    }
+
+    return true;
+}
+
+std::optional<sf::Event> Input::takePendingMove() {
+    std::optional<sf::Event> move = pendingMove;
+    pendingMove.reset();
+    return move;
+}
+
+void Input::endFrame() {
+    snapshot = current;
+}
+
+void Input::printStats() const {
+    if (stats.received == 0) return;
+
+    std::cout << "Input: " << stats.received << " events received, "
+        << stats.dispatched << " dispatched to scenes, "
+        << stats.received - stats.dispatched << " coalesced or dropped" << std::endl;
+}
@@ -0,0 +1,88 @@
+﻿// Input.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <bitset>
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+
+// Именованные действия: сцены спрашивают их, а не конкретные клавиши и кнопки
+enum class Action {
+    Confirm,
+    Up,
+    Down,
+    Left,
+    Right,
+    Select,
+    Randomize,
+    Count
+};
+
+// Неизменяемый снимок ввода за кадр. Game собирает его после разбора очереди событий
+// и отдает сцене через Scene::handleInput(). Нажатия относятся к кадру, а не к шагу update()
+struct InputSnapshot {
+    static constexpr std::size_t ACTION_COUNT = static_cast<std::size_t>(Action::Count);
+
+    std::bitset<ACTION_COUNT> actionsPressed;
+
+    sf::Vector2i pointer;          // пиксели окна
+    bool pointerInside = false;
+
+    bool wasPressed(Action action) const { return actionsPressed.test(static_cast<std::size_t>(action)); }
+
+    // Курсор в координатах холста или nullopt, если он вне окна
+    std::optional<sf::Vector2f> getPointer(const sf::RenderWindow& window) const;
+};
+
+// Слой ввода между окном и сценами.
+// Подряд идущие MouseMoved схлопываются в одно: сцена получает не больше одного движения
+// между соседними событиями других типов, сколько бы их ни прислала мышь с высоким опросом
+class Input {
+public:
+    struct Stats {
+        std::size_t received = 0;
+        std::size_t dispatched = 0;
+    };
+
+    static Input& instance();
+
+    // Позиция курсора для только что созданного окна — до первого MouseMoved
+    void syncPointer(const sf::RenderWindow& window);
+
+    void beginFrame();
+
+    // Учитывает событие в снимке. false — событие придержано (движение мыши) и отдавать его сейчас не нужно;
+    // true — отдать сцене, предварительно забрав takePendingMove()
+    bool process(const sf::Event& event);
+
+    // Последнее придержанное движение мыши, если оно было
+    std::optional<sf::Event> takePendingMove();
+
+    void endFrame();
+    const InputSnapshot& getSnapshot() const { return snapshot; }
+
+    // Действие, которое включает это событие (KeyPressed или MouseButtonPressed)
+    std::optional<Action> getAction(const sf::Event& event) const;
+
+    void bind(sf::Keyboard::Scancode key, Action action);
+    void bind(sf::Mouse::Button button, Action action);
+    void resetBindings();
+
+    void noteDispatched() { stats.dispatched++; }
+    void printStats() const;
+
+private:
+    Input();
+
+    void press(std::optional<Action> action);
+    std::optional<Action> findAction(sf::Keyboard::Scancode key) const;
+    std::optional<Action> findAction(sf::Mouse::Button button) const;
+
+    std::unordered_map<int, Action> keyBindings;
+    std::unordered_map<int, Action> buttonBindings;
+
+    InputSnapshot current;   // копится во время разбора очереди
+    InputSnapshot snapshot;  // отдается сценам
+    std::optional<sf::Event> pendingMove;
+    Stats stats;
+};
@@ -9,65 +9,39 @@
 #include <Scene.h>
 #include <SFML/Window/Event.hpp>
 #include <SFML/Graphics.hpp>
-#include "SettingsScene.h"
-#include "CharacterCreationScenes.h"
+#include "RenderQueue.h"
 #include "SaveManager.h"
+#include "ResourceCache.h"
+#include "Input.h"
 
 MainMenuScene::MainMenuScene(GameConfig& config) : config(config) {
-    // Инициализация генератора случайных чисел
-    std::srand(std::time(nullptr));
-
-    // Загрузка шрифта в SFML 3.1
-    bool fontLoaded = false;
-
-    // Попробуем разные пути для шрифта
-    std::vector<std::string> fontPaths = {
-        "assets/fonts/digital-7 (italic).ttf",
-        "arial.ttf",
-        "../assets/fonts/arial.ttf",
-        "C:\\Windows\\Fonts\\arial.ttf",  // Системный шрифт Windows
-        "C:\\Windows\\Fonts\\calibri.ttf" // Альтернативный системный шрифт
-    };
-
-    for (const auto& path : fontPaths) {
-        if (font.openFromFile(path)) {
-            fontLoaded = true;
-            std::cout << "Font loaded successfully from: " << path << std::endl;
-            break;
-        }
-    }
+    // Шрифт и фон берем из общего кэша, повторный вход в меню не читает диск.
+    // Текст рисуется из SDF-атласа, поэтому масштаб окна не растеризует новые страницы глифов
+    auto& cache = ResourceCache::instance();
+    font = cache.getSdfFont("font.ui");
+    backgroundTexture = cache.getTexture("tex.menu");
 
-    if (!backgroundTexture.loadFromFile("assets/textures/menu.png")) {
+    if (backgroundTexture->getSize().x == 0) {
         std::cerr << "Failed to load background image.\n";
     }
-    else {
-        // Правильная инициализация для std::optional<sf::Sprite>
-        backgroundSprite.emplace(backgroundTexture);
-
-    }
-
-    if (!fontLoaded) {
-        std::cerr << "Warning: Could not load any font file. Text may not display correctly." << std::endl;
-    }
 
-    // Правильная инициализация sf::Text для SFML 3.1
-    titleText = std::make_unique<sf::Text>(font);
+    titleText = std::make_unique<SdfText>(font);
     titleText->setString("NEUROCIPHER REBOOT");
     titleText->setFillColor(sf::Color(139, 0, 0));
 
-    startText = std::make_unique<sf::Text>(font);
+    startText = std::make_unique<SdfText>(font);
     startText->setString("Start game");
     startText->setFillColor(sf::Color(139, 0, 0));
 
-    loadText = std::make_unique<sf::Text>(font);
+    loadText = std::make_unique<SdfText>(font);
     loadText->setString("Load game");
     loadText->setFillColor(sf::Color(139, 0, 0));
 
-    optionsText = std::make_unique<sf::Text>(font);
+    optionsText = std::make_unique<SdfText>(font);
     optionsText->setString("Options");
     optionsText->setFillColor(sf::Color(139, 0, 0));
 
-    exitText = std::make_unique<sf::Text>(font);
+    exitText = std::make_unique<SdfText>(font);
     exitText->setString("Exit");
     exitText->setFillColor(sf::Color(139, 0, 0));
     
@@ -80,63 +54,32 @@ MainMenuScene::MainMenuScene(GameConfig& config) : config(config) {
 }
 
 void MainMenuScene::update(float deltaTime, sf::RenderWindow& window) {
-
-    // Hover update
-    updatePositions(window);
-    hoveredIndex = -1;
-    sf::Vector2i pixelPos = sf::Mouse::getPosition(window);
-    sf::Vector2f mousePos = window.mapPixelToCoords(pixelPos);
-    for (size_t i = 0; i < menuItems.size(); ++i) {
-        if (menuItems[i]->getGlobalBounds().contains(mousePos)) {
-            hoveredIndex = static_cast<int>(i);
-            break;
-        }
-    }
-
     glitchRenderer.update(deltaTime);
 }
 
-void MainMenuScene::render(sf::RenderWindow& window) {
-    if (backgroundSprite.has_value()) {
-        auto windowSize = window.getSize();
-        auto textureSize = backgroundTexture.getSize();
+void MainMenuScene::render(sf::RenderTarget& target) {
+    // Рендерим фон с глич-эффектом: запеченный слой рисуется один раз на весь экран
+    glitchRenderer.renderBackground(target, *backgroundTexture);
 
-        // Вычисляем масштаб для заполнения всего окна
-        float scaleX = static_cast<float>(windowSize.x) / textureSize.x;
-        float scaleY = static_cast<float>(windowSize.y) / textureSize.y;
-        float scale = std::max(scaleX, scaleY);
-
-        backgroundSprite->setScale(sf::Vector2f(scale, scale));
-
-        float spriteWidth = static_cast<float>(textureSize.x) * scale;
-        float spriteHeight = static_cast<float>(textureSize.y) * scale;
-        float offsetX = (static_cast<float>(windowSize.x) - spriteWidth) / 2.f;
-        float offsetY = (static_cast<float>(windowSize.y) - spriteHeight) / 2.f;
-
-        backgroundSprite->setScale(sf::Vector2f(scaleX, scaleY));
-        window.draw(backgroundSprite.value());
-    }
-
-    // Рендерим фон с глич-эффектом
-    glitchRenderer.renderBackground(window, backgroundTexture);
-
-    // Рендерим заголовок с глич-эффектом
-    glitchRenderer.renderGlitchText(window, *titleText, "NEUROCIPHER REBOOT");
-    window.draw(*titleText);
+    // Рендерим заголовок с глич-эффектом: призраки и сам текст уходят в очередь одним пакетом
+    auto& queue = RenderQueue::instance();
+    glitchRenderer.renderGlitchText(target, *titleText);
+    queue.submit(*titleText, RenderQueue::LAYER_TEXT);
 
     // Остальные элементы меню...
-    window.draw(*startText);
-    window.draw(*loadText);
-    window.draw(*optionsText);
-    window.draw(*exitText);
+    queue.submit(*startText, RenderQueue::LAYER_TEXT);
+    queue.submit(*loadText, RenderQueue::LAYER_TEXT);
+    queue.submit(*optionsText, RenderQueue::LAYER_TEXT);
+    queue.submit(*exitText, RenderQueue::LAYER_TEXT);
+    queue.flush(target);
 
     // Глич-линии при наведении
-    if (hoveredIndex != -1 && hoveredIndex < menuItems.size()) {
-        glitchRenderer.renderHoverGlitch(window, menuItems[hoveredIndex]->getGlobalBounds());
+    if (const sf::FloatRect* bounds = hitGrid.getBounds(hoveredIndex)) {
+        glitchRenderer.renderHoverGlitch(target, *bounds);
     }
 
     // Общие глич-линии на экране
-    glitchRenderer.renderGlitchLines(window, 15);
+    glitchRenderer.renderGlitchLines(target, 15);
 
     // Включение затемнения на 30%
     glitchRenderer.setBackgroundDarkening(true, 0.3f);
@@ -148,89 +91,93 @@ void MainMenuScene::render(sf::RenderWindow& window) {
     glitchRenderer.setCyberpunkSquares(true);
 
     // В цикле рендеринга
-    glitchRenderer.renderCyberpunkSquares(window, 8); // 8 квадратов
+    glitchRenderer.renderCyberpunkSquares(target, 8); // 8 квадратов
+
+    glitchRenderer.flushOverlay(target);
 }
 
 void MainMenuScene::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
-    if (event.getIf<sf::Event::MouseButtonPressed>()) {
-        sf::Vector2i pixelPos = sf::Mouse::getPosition(window);
-        sf::Vector2f worldPos = window.mapPixelToCoords(pixelPos);
-
-        for (size_t i = 0; i < menuItems.size(); ++i) {
-            if (menuItems[i]->getGlobalBounds().contains(worldPos)) {
-                switch (i) {
-                case 0:
-                    std::cout << "Start Game clicked\n";
-                    onStartGameClicked();
-                    break;
-                case 1:
-                    std::cout << "Load Game clicked\n";
-                    break;
-                case 2:
-                    std::cout << "Options clicked\n";
-                    nextScene = std::make_unique<SettingsScene>(config);
-                    finished = true;
-                    break;
-                case 3:
-                    window.close(); // Выход
-                    break;
-                }
+    const std::optional<Action> action = Input::instance().getAction(event);
+
+    if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+        hoveredIndex = hitGrid.hitTest(window.mapPixelToCoords(moved->position));
+    }
+    else if (event.is<sf::Event::MouseLeft>()) {
+        hoveredIndex = -1;
+    }
+
+    if (const auto* pressed = event.getIf<sf::Event::MouseButtonPressed>(); pressed && action == Action::Select) {
+        int i = hitGrid.hitTest(window.mapPixelToCoords(pressed->position));
+        if (i != -1) {
+            glitchRenderer.emitBurst(*hitGrid.getBounds(i));
+            switch (i) {
+            case 0:
+                std::cout << "Start Game clicked\n";
+                onStartGameClicked();
+                break;
+            case 1:
+                std::cout << "Load Game clicked\n";
+                break;
+            case 2:
+                std::cout << "Options clicked\n";
+                requestTransition(SceneTransition::push(SceneId::Settings));
+                break;
+            case 3:
+                window.close(); // Выход
+                break;
             }
         }
     }
 
+    // Отладочные клавиши остаются привязаны к конкретным кнопкам, это не игровые действия
     if (const auto* keyEvent = event.getIf<sf::Event::KeyPressed>()) {
-        if (keyEvent->scancode == sf::Keyboard::Scancode::Enter) {
-            std::cout << "Enter key pressed\n";
+        if (keyEvent->scancode == sf::Keyboard::Scancode::F3) {
+            // Счетчики отрисовки оверлея за последний кадр
+            glitchRenderer.printStats();
+            RenderQueue::instance().printStats("MainMenuScene");
+            Input::instance().printStats();
+        }
+        if (keyEvent->scancode == sf::Keyboard::Scancode::F5) {
+            ParticleSystem::runBenchmark();
+        }
+        if (keyEvent->scancode == sf::Keyboard::Scancode::F4) {
+            // Переключение между шейдерным проходом и спрайтовым путем для сравнения
+            glitchRenderer.setShaderEnabled(!glitchRenderer.isShaderActive());
+            std::cout << "Glitch shader " << (glitchRenderer.isShaderActive() ? "on" : "off") << std::endl;
         }
     }
 }
 
-bool MainMenuScene::isFinished() const {
-    return finished; // Главное меню не завершает себя само
-}
-
-std::unique_ptr<Scene> MainMenuScene::extractNextScene() {
-    return std::move(nextScene);
-}
-
-void MainMenuScene::updatePositions() {
+void MainMenuScene::handleInput(const InputSnapshot& input) {
+    if (input.wasPressed(Action::Confirm)) {
+        std::cout << "Enter key pressed\n";
+    }
 }
 
-void MainMenuScene::updatePositions(sf::RenderWindow& window) {
-    auto windowSize = window.getSize();
-
-    // Базовые размеры для масштабирования
-    float baseWidth = 1280.0f;
-    float baseHeight = 720.0f;
-
-    // Вычисляем масштаб на основе текущего размера окна
-    float scaleX = static_cast<float>(windowSize.x) / baseWidth;
-    float scaleY = static_cast<float>(windowSize.y) / baseHeight;
-    float scale = std::min(scaleX, scaleY); // Используем минимальный масштаб для сохранения пропорций
-
-    // Базовые позиции и размеры
+void MainMenuScene::layout(sf::RenderWindow& window) {
+    // Координаты холста 1280x720, окно масштабирует их видом; SDF-текст не зависит от разрешения
     float baseX = 100.0f;
     float baseY = 100.0f;
     float baseTitleSize = 76.0f;
     float baseMenuSize = 24.0f;
     float baseMenuSpacing = 50.0f;
 
-    // Применяем масштаб к размерам текста
-    titleText->setCharacterSize(static_cast<unsigned int>(baseTitleSize * scale));
-    startText->setCharacterSize(static_cast<unsigned int>(baseMenuSize * scale));
-    loadText->setCharacterSize(static_cast<unsigned int>(baseMenuSize * scale));
-    optionsText->setCharacterSize(static_cast<unsigned int>(baseMenuSize * scale));
-    exitText->setCharacterSize(static_cast<unsigned int>(baseMenuSize * scale));
-    
+    titleText->setCharacterSize(static_cast<unsigned int>(baseTitleSize));
+    titleText->setPosition(sf::Vector2f(baseX, baseY));
 
-    // Применяем масштаб к позициям
-    titleText->setPosition(sf::Vector2f(baseX * scaleX, baseY * scaleY));
-    startText->setPosition(sf::Vector2f(baseX * scaleX, (baseY + 200.0f) * scaleY));
-    loadText->setPosition(sf::Vector2f(baseX * scaleX, (baseY + 250.0f) * scaleY));
-    optionsText->setPosition(sf::Vector2f(baseX * scaleX, (baseY + 300.0f) * scaleY));
-    exitText->setPosition(sf::Vector2f(baseX * scaleX, (baseY + 350.0f) * scaleY));
-    
+    for (std::size_t i = 0; i < menuItems.size(); ++i) {
+        menuItems[i]->setCharacterSize(static_cast<unsigned int>(baseMenuSize));
+        menuItems[i]->setPosition(sf::Vector2f(baseX, baseY + 200.0f + baseMenuSpacing * static_cast<float>(i)));
+    }
+
+    hitGrid.clear();
+    for (std::size_t i = 0; i < menuItems.size(); ++i) {
+        hitGrid.insert(static_cast<int>(i), menuItems[i]->getGlobalBounds());
+    }
+
+    // Курсор мог оказаться над другим пунктом без движения мыши
+    auto pointer = Input::instance().getSnapshot().getPointer(window);
+    hoveredIndex = pointer ? hitGrid.hitTest(*pointer) : -1;
 }
 
 void MainMenuScene::onStartGameClicked() {
@@ -265,8 +212,7 @@ void MainMenuScene::onStartGameClicked() {
         return;
     }
 
-    // Переходим к следующей сцене — созданию персонажа или игре
-    nextScene = std::make_unique<CharacterOrigin>(config);
-    finished = true;
+    // Создание персонажа открывается поверх меню; по завершении стек вернется сюда
+    requestTransition(SceneTransition::push(SceneId::CharacterOrigin, { { "save", uniqueSaveName } }));
 }
 
@@ -5,38 +5,35 @@
 #include "Scene.h"
 #include "Config.h"
 #include "GlitchRenderer.h"
+#include "SdfText.h"
 #include "SaveManager.h"
+#include "HitGrid.h"
 class MainMenuScene : public Scene {
 private:
-    sf::Texture backgroundTexture;
-    std::optional<sf::Sprite> backgroundSprite;
-    sf::Font font;
+    std::shared_ptr<sf::Texture> backgroundTexture;
+    std::shared_ptr<SdfFont> font;
     GameConfig& config;
-    std::unique_ptr<sf::Text> titleText;
-    std::unique_ptr<sf::Text> startText;
-    std::unique_ptr<sf::Text> loadText;
-    std::unique_ptr<sf::Text> optionsText;
-    std::unique_ptr<sf::Text> exitText;
+    std::unique_ptr<SdfText> titleText;
+    std::unique_ptr<SdfText> startText;
+    std::unique_ptr<SdfText> loadText;
+    std::unique_ptr<SdfText> optionsText;
+    std::unique_ptr<SdfText> exitText;
 
     GlitchRenderer glitchRenderer;
     SaveManager saveManager;
-    std::unique_ptr<Scene> nextScene;
-    std::vector<sf::Text*> menuItems;
-    
+    std::vector<SdfText*> menuItems;
+
+    // Границы пунктов кэшируются в layout(); наведение меняется только на MouseMoved
+    HitGrid hitGrid;
     int hoveredIndex = -1;
 
-    
-    bool finished = false;
-    
-    void updatePositions();
-    void updatePositions(sf::RenderWindow& window);
     void onStartGameClicked();
 public:
     MainMenuScene(GameConfig& config);
     void update(float deltaTime, sf::RenderWindow& window) override;
-    void render(sf::RenderWindow& window) override;
+    void render(sf::RenderTarget& target) override;
+    void layout(sf::RenderWindow& window) override;
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
-    bool isFinished() const override;
-    std::unique_ptr<Scene> extractNextScene();
+    void handleInput(const InputSnapshot& input) override;
 };
 
@@ -0,0 +1,155 @@
+﻿#include "PaletteRecolor.h"
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NC_RECOLOR_SSE2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2-функции компилируются отдельно от остального файла и вызываются только после проверки CPU
+#if defined(NC_RECOLOR_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define NC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NC_TARGET_AVX2
+#endif
+
+namespace {
+    using Kernel = void (*)(const std::uint8_t*, std::uint8_t*, std::size_t, const std::uint32_t*);
+
+    std::uint8_t lerpChannel(std::uint8_t from, std::uint8_t to, int step, int steps) {
+        return static_cast<std::uint8_t>(from + (to - from) * step / steps);
+    }
+
+    std::uint32_t packRgb(std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+        // Порядок байт как в sf::Image, независимо от порядка байт платформы
+        const std::uint8_t bytes[4] = { r, g, b, 0 };
+        std::uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    void recolorScalar(const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* lut) {
+        for (std::size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+            std::memcpy(dst, &lut[src[0]], 3);
+            dst[3] = src[3];
+        }
+    }
+
+#ifdef NC_RECOLOR_SSE2
+    // Маски ниже рассчитаны на little-endian, что верно для всех x86
+    void recolorSse2(const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* lut) {
+        const __m128i indexMask = _mm_set1_epi32(0xFF);
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+
+            // В SSE2 нет gather: индексы достаем в память, выборку собираем из четырех чтений
+            alignas(16) std::uint32_t indices[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_and_si128(pixels, indexMask));
+            __m128i colors = _mm_set_epi32(
+                static_cast<int>(lut[indices[3]]), static_cast<int>(lut[indices[2]]),
+                static_cast<int>(lut[indices[1]]), static_cast<int>(lut[indices[0]]));
+
+            __m128i result = _mm_or_si128(colors, _mm_and_si128(pixels, alphaMask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), result);
+        }
+
+        recolorScalar(src + i * 4, dst + i * 4, count - i, lut);
+    }
+
+    NC_TARGET_AVX2 void recolorAvx2(const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* lut) {
+        const __m256i indexMask = _mm256_set1_epi32(0xFF);
+        const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            __m256i indices = _mm256_and_si256(pixels, indexMask);
+            __m256i colors = _mm256_i32gather_epi32(reinterpret_cast<const int*>(lut), indices, 4);
+
+            __m256i result = _mm256_or_si256(colors, _mm256_and_si256(pixels, alphaMask));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), result);
+        }
+
+        recolorScalar(src + i * 4, dst + i * 4, count - i, lut);
+    }
+
+    bool cpuHasAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        // AVX требует поддержки от ОС (сохранение YMM-регистров)
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    struct KernelChoice {
+        Kernel kernel;
+        const char* name;
+    };
+
+    const KernelChoice& selectKernel() {
+        static const KernelChoice choice = []() -> KernelChoice {
+#ifdef NC_RECOLOR_SSE2
+            if (cpuHasAvx2()) return { recolorAvx2, "AVX2" };
+            return { recolorSse2, "SSE2" };
+#else
+            return { recolorScalar, "scalar" };
+#endif
+        }();
+        return choice;
+    }
+}
+
+RecolorPalette RecolorPalette::fromRamp(sf::Color shadow, sf::Color base, sf::Color highlight) {
+    RecolorPalette palette;
+    for (int i = 0; i < 256; ++i) {
+        sf::Color from = i < 128 ? shadow : base;
+        sf::Color to = i < 128 ? base : highlight;
+        int step = i < 128 ? i : i - 128;
+        int steps = i < 128 ? 128 : 127;
+
+        palette.entries[i] = packRgb(
+            lerpChannel(from.r, to.r, step, steps),
+            lerpChannel(from.g, to.g, step, steps),
+            lerpChannel(from.b, to.b, step, steps));
+    }
+    return palette;
+}
+
+void PaletteRecolor::recolor(const std::uint8_t* maskPixels, std::uint8_t* outPixels,
+    std::size_t pixelCount, const RecolorPalette& palette) {
+    selectKernel().kernel(maskPixels, outPixels, pixelCount, palette.entries.data());
+}
+
+sf::Image PaletteRecolor::recolor(const sf::Image& mask, const RecolorPalette& palette) {
+    auto size = mask.getSize();
+    if (size.x == 0 || size.y == 0) return sf::Image();
+
+    // sf::Image не дает писать в буфер напрямую, поэтому перекрашиваем во временный
+    std::size_t pixelCount = static_cast<std::size_t>(size.x) * size.y;
+    std::vector<std::uint8_t> pixels(pixelCount * 4);
+    recolor(mask.getPixelsPtr(), pixels.data(), pixelCount, palette);
+    return sf::Image(size, pixels.data());
+}
+
+const char* PaletteRecolor::getKernelName() {
+    return selectKernel().name;
+}
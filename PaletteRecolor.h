@@ -0,0 +1,27 @@
+﻿// PaletteRecolor.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Палитра на 256 записей: индекс — яркость маски (канал R), значение — цвет RGB.
+// Записи хранятся байтами RGBA подряд с нулевой альфой, как пиксели sf::Image.
+struct RecolorPalette {
+    alignas(32) std::array<std::uint32_t, 256> entries{};
+
+    // Кусочно-линейный градиент: 0 — тень, 128 — основной цвет, 255 — блик
+    static RecolorPalette fromRamp(sf::Color shadow, sf::Color base, sf::Color highlight);
+};
+
+// Перекраска серых масок по палитре. Ядро выбирается один раз при первом вызове:
+// AVX2 (gather по 8 пикселей), SSE2 (по 4), иначе скалярный цикл.
+class PaletteRecolor {
+public:
+    // Цвет берется из палитры по каналу R маски, альфа — из маски
+    static void recolor(const std::uint8_t* maskPixels, std::uint8_t* outPixels,
+        std::size_t pixelCount, const RecolorPalette& palette);
+    static sf::Image recolor(const sf::Image& mask, const RecolorPalette& palette);
+
+    static const char* getKernelName();
+};
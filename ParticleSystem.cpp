@@ -0,0 +1,188 @@
+﻿#include "ParticleSystem.h"
+#include "Rng.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#if defined(_MSC_VER)
+#define NC_RESTRICT __restrict
+#else
+#define NC_RESTRICT __restrict__
+#endif
+
+namespace {
+    // Случайных чисел на одну частицу: x, y, время жизни, скорость, угол, размер, цвет
+    constexpr std::size_t RANDOMS_PER_PARTICLE = 7;
+
+    float lerp(float a, float b, float t) {
+        return a + (b - a) * t;
+    }
+}
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : capacity(capacity),
+    positionX(capacity), positionY(capacity),
+    velocityX(capacity), velocityY(capacity),
+    size(capacity), lifetime(capacity), inverseMaxLifetime(capacity),
+    color(capacity) {
+    randomBatch.reserve(1024 * RANDOMS_PER_PARTICLE);
+}
+
+std::size_t ParticleSystem::addEmitter(const ParticleEmitterDesc& desc) {
+    Emitter emitter;
+    emitter.desc = desc;
+    emitters.push_back(emitter);
+    return emitters.size() - 1;
+}
+
+void ParticleSystem::setEmitterArea(std::size_t index, const sf::FloatRect& area) {
+    if (index >= emitters.size()) return;
+
+    emitters[index].area = area;
+    emitters[index].armed = true;
+}
+
+void ParticleSystem::setEmitterActive(std::size_t index, bool active) {
+    if (index < emitters.size()) emitters[index].active = active;
+}
+
+void ParticleSystem::burst(std::size_t index) {
+    if (index < emitters.size()) emitters[index].pendingBurst += emitters[index].desc.burstCount;
+}
+
+void ParticleSystem::update(float deltaTime) {
+    // Рождение
+    for (auto& emitter : emitters) {
+        std::size_t amount = emitter.pendingBurst;
+        emitter.pendingBurst = 0;
+
+        bool emitting = emitter.desc.kind == ParticleEmitterDesc::Kind::Hover ? emitter.armed : emitter.active;
+        if (emitting && emitter.desc.rate > 0.f) {
+            emitter.accumulator += emitter.desc.rate * deltaTime;
+            std::size_t whole = static_cast<std::size_t>(emitter.accumulator);
+            emitter.accumulator -= static_cast<float>(whole);
+            amount += whole;
+        }
+        else {
+            emitter.accumulator = 0.f;
+        }
+
+        // Наведение нужно подтверждать каждый кадр
+        emitter.armed = false;
+        if (amount > 0) spawn(emitter, amount);
+    }
+
+    // Движение и старение — отдельными массивами без ветвлений
+    const std::size_t n = count;
+    float* NC_RESTRICT px = positionX.data();
+    float* NC_RESTRICT py = positionY.data();
+    const float* NC_RESTRICT vx = velocityX.data();
+    const float* NC_RESTRICT vy = velocityY.data();
+    float* NC_RESTRICT life = lifetime.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        px[i] += vx[i] * deltaTime;
+        py[i] += vy[i] * deltaTime;
+        life[i] -= deltaTime;
+    }
+
+    // Удаление умерших: на место умершей встает последняя живая
+    for (std::size_t i = 0; i < count;) {
+        if (lifetime[i] <= 0.f) {
+            kill(i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void ParticleSystem::kill(std::size_t index) {
+    std::size_t last = --count;
+    positionX[index] = positionX[last];
+    positionY[index] = positionY[last];
+    velocityX[index] = velocityX[last];
+    velocityY[index] = velocityY[last];
+    size[index] = size[last];
+    lifetime[index] = lifetime[last];
+    inverseMaxLifetime[index] = inverseMaxLifetime[last];
+    color[index] = color[last];
+}
+
+void ParticleSystem::spawn(const Emitter& emitter, std::size_t amount) {
+    amount = std::min(amount, capacity - count);
+    if (amount == 0 || emitter.desc.palette.empty()) return;
+
+    const ParticleEmitterDesc& desc = emitter.desc;
+    randomBatch.resize(amount * RANDOMS_PER_PARTICLE);
+    Rng::instance().stream(RngStreamId::Glitch).fill(randomBatch.data(), randomBatch.size());
+
+    float baseAngle = std::atan2(desc.direction.y, desc.direction.x);
+    for (std::size_t k = 0; k < amount; ++k) {
+        const float* r = &randomBatch[k * RANDOMS_PER_PARTICLE];
+        std::size_t i = count++;
+
+        positionX[i] = emitter.area.position.x + r[0] * emitter.area.size.x;
+        positionY[i] = emitter.area.position.y + r[1] * emitter.area.size.y;
+
+        float life = lerp(desc.minLifetime, desc.maxLifetime, r[2]);
+        lifetime[i] = life;
+        inverseMaxLifetime[i] = life > 0.f ? 1.f / life : 0.f;
+
+        float speed = lerp(desc.minSpeed, desc.maxSpeed, r[3]);
+        float angle = baseAngle + (r[4] - 0.5f) * desc.spread;
+        velocityX[i] = std::cos(angle) * speed;
+        velocityY[i] = std::sin(angle) * speed;
+
+        size[i] = lerp(desc.minSize, desc.maxSize, r[5]);
+        std::size_t paletteIndex = std::min(static_cast<std::size_t>(r[6] * desc.palette.size()), desc.palette.size() - 1);
+        color[i] = desc.palette[paletteIndex];
+    }
+}
+
+void ParticleSystem::writeQuads(sf::Vertex* v) const {
+    for (std::size_t i = 0; i < count; ++i, v += 6) {
+        float left = positionX[i];
+        float top = positionY[i];
+        float right = left + size[i];
+        float bottom = top + size[i];
+
+        // К концу жизни фрагмент гаснет
+        sf::Color c = color[i];
+        c.a = static_cast<std::uint8_t>(c.a * std::min(lifetime[i] * inverseMaxLifetime[i], 1.f));
+
+        v[0] = { { left, top }, c };
+        v[1] = { { right, top }, c };
+        v[2] = { { left, bottom }, c };
+        v[3] = { { left, bottom }, c };
+        v[4] = { { right, top }, c };
+        v[5] = { { right, bottom }, c };
+    }
+}
+
+void ParticleSystem::runBenchmark(std::size_t particleCount, int frames) {
+    ParticleSystem system(particleCount);
+
+    // Долгоживущие частицы, чтобы пул оставался заполненным весь замер
+    ParticleEmitterDesc desc;
+    desc.kind = ParticleEmitterDesc::Kind::Burst;
+    desc.burstCount = particleCount;
+    desc.minLifetime = 1000.f;
+    desc.maxLifetime = 1000.f;
+    std::size_t emitter = system.addEmitter(desc);
+    system.setEmitterArea(emitter, sf::FloatRect({ 0.f, 0.f }, { 1920.f, 1080.f }));
+    system.burst(emitter);
+    system.update(0.f);
+
+    std::vector<sf::Vertex> vertices(system.getVertexCount());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        system.update(1.f / 60.f);
+        system.writeQuads(vertices.data());
+    }
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "ParticleSystem benchmark: " << system.getCount() << " particles, "
+        << totalMs / frames << " ms per frame (update + quads)" << std::endl;
+}
@@ -0,0 +1,350 @@
+﻿#include "RenderQueue.h"
+#include "SdfText.h"
+#include "SdfFont.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+
+RenderQueue& RenderQueue::instance() {
+    static RenderQueue queue;
+    return queue;
+}
+
+RenderQueue::Item& RenderQueue::pushItem(int layer, std::int32_t sortKey, const sf::Texture* texture) {
+    Item item;
+    item.layer = layer;
+    item.sortKey = sortKey;
+    item.texture = texture;
+    item.sequence = static_cast<std::uint32_t>(items.size());
+    item.firstVertex = staging.size();
+    items.push_back(item);
+    frameStats.submitted++;
+    return items.back();
+}
+
+void RenderQueue::appendQuad(sf::Vector2f p0, sf::Vector2f p1, sf::Vector2f p2, sf::Vector2f p3, sf::Color color,
+    sf::FloatRect texRect) {
+    // p0..p3 идут по кругу: левый верх, правый верх, правый низ, левый низ
+    float left = texRect.position.x;
+    float top = texRect.position.y;
+    float right = left + texRect.size.x;
+    float bottom = top + texRect.size.y;
+
+    staging.push_back({ p0, color, { left, top } });
+    staging.push_back({ p1, color, { right, top } });
+    staging.push_back({ p3, color, { left, bottom } });
+    staging.push_back({ p3, color, { left, bottom } });
+    staging.push_back({ p1, color, { right, top } });
+    staging.push_back({ p2, color, { right, bottom } });
+}
+
+void RenderQueue::submit(const sf::Sprite& sprite, int layer, std::int32_t sortKey) {
+    Item& item = pushItem(layer, sortKey, &sprite.getTexture());
+
+    sf::FloatRect rect(sprite.getTextureRect());
+    float width = std::abs(rect.size.x);
+    float height = std::abs(rect.size.y);
+    const sf::Transform& transform = sprite.getTransform();
+
+    appendQuad(transform.transformPoint({ 0.f, 0.f }), transform.transformPoint({ width, 0.f }),
+        transform.transformPoint({ width, height }), transform.transformPoint({ 0.f, height }),
+        sprite.getColor(), rect);
+
+    item.vertexCount = staging.size() - item.firstVertex;
+    frameStats.batched++;
+}
+
+void RenderQueue::submit(const sf::RectangleShape& shape, int layer, std::int32_t sortKey) {
+    const sf::Transform& transform = shape.getTransform();
+    sf::Vector2f size = shape.getSize();
+    const sf::Texture* texture = shape.getTexture();
+
+    // Прозрачную заливку не отправляем вовсе — у рамок кнопок она обычно такая
+    if (shape.getFillColor().a > 0 || texture) {
+        Item& fill = pushItem(layer, sortKey, texture);
+        sf::FloatRect texRect = texture ? sf::FloatRect(shape.getTextureRect()) : sf::FloatRect();
+        appendQuad(transform.transformPoint({ 0.f, 0.f }), transform.transformPoint({ size.x, 0.f }),
+            transform.transformPoint(size), transform.transformPoint({ 0.f, size.y }),
+            shape.getFillColor(), texRect);
+        fill.vertexCount = staging.size() - fill.firstVertex;
+        frameStats.batched++;
+    }
+
+    float thickness = shape.getOutlineThickness();
+    if (thickness == 0.f || shape.getOutlineColor().a == 0) return;
+
+    // Рамка — четыре полосы между внутренним и сдвинутым на толщину контуром
+    Item& outline = pushItem(layer, sortKey, nullptr);
+    const sf::Vector2f inner[4] = { { 0.f, 0.f }, { size.x, 0.f }, size, { 0.f, size.y } };
+    const sf::Vector2f corner[4] = { { -1.f, -1.f }, { 1.f, -1.f }, { 1.f, 1.f }, { -1.f, 1.f } };
+    for (int i = 0; i < 4; ++i) {
+        int j = (i + 1) % 4;
+        sf::Vector2f a = inner[i];
+        sf::Vector2f b = inner[j];
+        sf::Vector2f outerA = a + corner[i] * thickness;
+        sf::Vector2f outerB = b + corner[j] * thickness;
+        appendQuad(transform.transformPoint(outerA), transform.transformPoint(outerB),
+            transform.transformPoint(b), transform.transformPoint(a), shape.getOutlineColor());
+    }
+    outline.vertexCount = staging.size() - outline.firstVertex;
+    frameStats.batched++;
+}
+
+void RenderQueue::submit(const sf::Text& text, int layer, std::int32_t sortKey) {
+    // Обводку и начертания, которые SFML достраивает отдельной геометрией, рисует сам sf::Text
+    if (text.getOutlineThickness() != 0.f || text.getStyle() != sf::Text::Regular) {
+        submit(text, layer, sortKey, &text.getFont().getTexture(text.getCharacterSize()));
+        return;
+    }
+
+    Item& item = pushItem(layer, sortKey, &text.getFont().getTexture(text.getCharacterSize()));
+    appendTextQuads(text, text.getTransform(), text.getFillColor(), staging);
+    item.vertexCount = staging.size() - item.firstVertex;
+    frameStats.batched++;
+}
+
+void RenderQueue::submit(const SdfText& text, int layer, std::int32_t sortKey) {
+    const sf::Texture* texture = text.getFont() ? &text.getFont()->getTexture() : nullptr;
+    if (!texture || !text.getFont()->isReady()) {
+        submit(static_cast<const sf::Drawable&>(text), layer, sortKey, texture);
+        return;
+    }
+
+    Item& item = pushItem(layer, sortKey, texture);
+    item.sdfFont = text.getFont().get();
+    item.sdfScale = text.getSmoothingScale();
+    text.appendVertices(staging);
+    item.vertexCount = staging.size() - item.firstVertex;
+    frameStats.batched++;
+}
+
+bool RenderQueue::submitGhost(const SdfText& text, sf::Vector2f offset, sf::Color color, int layer, std::int32_t sortKey) {
+    if (!text.getFont() || !text.getFont()->isReady()) return false;
+
+    Item& item = pushItem(layer, sortKey, &text.getFont()->getTexture());
+    item.sdfFont = text.getFont().get();
+    item.sdfScale = text.getSmoothingScale();
+    text.appendVertices(staging, offset, color);
+    item.vertexCount = staging.size() - item.firstVertex;
+    frameStats.batched++;
+    return true;
+}
+
+void RenderQueue::submit(const sf::Drawable& drawable, int layer, std::int32_t sortKey,
+    const sf::Texture* texture, const sf::RenderStates& states) {
+    Item& item = pushItem(layer, sortKey, texture);
+    item.drawable = &drawable;
+    item.states = states;
+}
+
+void RenderQueue::appendTextQuads(const sf::Text& text, const sf::Transform& transform, sf::Color color, std::vector<sf::Vertex>& out) {
+    const sf::Font& font = text.getFont();
+    unsigned int characterSize = text.getCharacterSize();
+    const float padding = 1.f;
+
+    float whitespaceWidth = font.getGlyph(U' ', characterSize, false).advance;
+    const float letterSpacing = (whitespaceWidth / 3.f) * (text.getLetterSpacing() - 1.f);
+    whitespaceWidth += letterSpacing;
+    const float lineSpacing = font.getLineSpacing(characterSize) * text.getLineSpacing();
+
+    float x = 0.f;
+    float y = static_cast<float>(characterSize);
+    char32_t previous = 0;
+
+    for (char32_t current : text.getString()) {
+        if (current == U'\r') continue;
+
+        x += font.getKerning(previous, current, characterSize);
+        previous = current;
+
+        if (current == U' ' || current == U'\n' || current == U'\t') {
+            if (current == U' ') x += whitespaceWidth;
+            else if (current == U'\t') x += whitespaceWidth * 4.f;
+            else {
+                y += lineSpacing;
+                x = 0.f;
+            }
+            continue;
+        }
+
+        const sf::Glyph& glyph = font.getGlyph(current, characterSize, false);
+        float left = x + glyph.bounds.position.x - padding;
+        float top = y + glyph.bounds.position.y - padding;
+        float right = x + glyph.bounds.position.x + glyph.bounds.size.x + padding;
+        float bottom = y + glyph.bounds.position.y + glyph.bounds.size.y + padding;
+
+        float u1 = static_cast<float>(glyph.textureRect.position.x) - padding;
+        float v1 = static_cast<float>(glyph.textureRect.position.y) - padding;
+        float u2 = static_cast<float>(glyph.textureRect.position.x + glyph.textureRect.size.x) + padding;
+        float v2 = static_cast<float>(glyph.textureRect.position.y + glyph.textureRect.size.y) + padding;
+
+        sf::Vector2f p0 = transform.transformPoint({ left, top });
+        sf::Vector2f p1 = transform.transformPoint({ right, top });
+        sf::Vector2f p2 = transform.transformPoint({ right, bottom });
+        sf::Vector2f p3 = transform.transformPoint({ left, bottom });
+
+        out.push_back({ p0, color, { u1, v1 } });
+        out.push_back({ p1, color, { u2, v1 } });
+        out.push_back({ p3, color, { u1, v2 } });
+        out.push_back({ p3, color, { u1, v2 } });
+        out.push_back({ p1, color, { u2, v1 } });
+        out.push_back({ p2, color, { u2, v2 } });
+
+        x += glyph.advance + letterSpacing;
+    }
+}
+
+void RenderQueue::countBind(const sf::Texture* texture) {
+    if (!anyDraw || texture != boundTexture) {
+        if (texture) frameStats.textureBinds++;
+        boundTexture = texture;
+    }
+    anyDraw = true;
+    frameStats.drawCalls++;
+}
+
+void RenderQueue::drawVertices(sf::RenderTarget& target, const Item& batch, std::size_t first, std::size_t count) {
+    if (count == 0) return;
+
+    sf::RenderStates states;
+    states.texture = batch.texture;
+    if (batch.sdfFont) {
+        // Как в SdfText::draw: сглаживание по итоговому размеру на экране с учетом вида
+        float viewScale = static_cast<float>(target.getSize().x) / target.getView().getSize().x;
+        states.shader = batch.sdfFont->getShader(batch.sdfScale * viewScale);
+    }
+    target.draw(stream.data() + first, count, sf::PrimitiveType::Triangles, states);
+    countBind(batch.texture);
+    frameStats.vertices += count;
+}
+
+void RenderQueue::flush(sf::RenderTarget& target) {
+    if (deferredLayer != NO_DEFERRED_LAYER) {
+        deferItems();
+    }
+    if (items.empty()) return;
+
+    order.resize(items.size());
+    for (std::uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    // Квады раньше самостоятельных объектов с той же текстурой, чтобы склеиться в один поток
+    std::sort(order.begin(), order.end(), [this](std::uint32_t lhs, std::uint32_t rhs) {
+        const Item& a = items[lhs];
+        const Item& b = items[rhs];
+        if (a.layer != b.layer) return a.layer < b.layer;
+        if (a.sortKey != b.sortKey) return a.sortKey < b.sortKey;
+        if (a.texture != b.texture) return std::less<const sf::Texture*>()(a.texture, b.texture);
+        if (a.sdfScale != b.sdfScale) return a.sdfScale < b.sdfScale;
+        bool aQuads = a.drawable == nullptr;
+        bool bQuads = b.drawable == nullptr;
+        if (aQuads != bQuads) return aQuads;
+        return a.sequence < b.sequence;
+    });
+
+    stream.clear();
+    stream.reserve(staging.size());
+
+    // Пакет копится, пока подряд идут квады с одной текстурой
+    std::size_t batchStart = 0;
+    const Item* batch = nullptr;
+
+    for (std::uint32_t index : order) {
+        const Item& item = items[index];
+
+        if (batch && (item.drawable || item.texture != batch->texture || item.sdfScale != batch->sdfScale)) {
+            drawVertices(target, *batch, batchStart, stream.size() - batchStart);
+            batch = nullptr;
+        }
+
+        if (item.drawable) {
+            target.draw(*item.drawable, item.states);
+            countBind(item.states.texture ? item.states.texture : item.texture);
+            continue;
+        }
+
+        if (!batch) {
+            batchStart = stream.size();
+            batch = &item;
+        }
+        stream.insert(stream.end(), staging.begin() + item.firstVertex,
+            staging.begin() + item.firstVertex + item.vertexCount);
+    }
+
+    if (batch) {
+        drawVertices(target, *batch, batchStart, stream.size() - batchStart);
+    }
+
+    items.clear();
+    staging.clear();
+}
+
+void RenderQueue::deferLayersFrom(int layer) {
+    deferredLayer = layer;
+}
+
+void RenderQueue::deferItems() {
+    // Отложенные объекты переезжают со своими вершинами; порядок отправки между сбросами сохраняется
+    std::size_t kept = 0;
+    for (const Item& item : items) {
+        if (item.layer < deferredLayer) {
+            items[kept++] = item;
+            continue;
+        }
+
+        Item deferred = item;
+        deferred.sequence = static_cast<std::uint32_t>(deferredItems.size());
+        deferred.firstVertex = deferredStaging.size();
+        deferredStaging.insert(deferredStaging.end(), staging.begin() + item.firstVertex,
+            staging.begin() + item.firstVertex + item.vertexCount);
+        deferredItems.push_back(deferred);
+    }
+    items.resize(kept);
+}
+
+void RenderQueue::flushDeferred(sf::RenderTarget& target) {
+    // Остальное к этому моменту уже сброшено в свою цель. Буферы меняются местами,
+    // а не копируются: емкость обоих сохраняется между кадрами
+    deferredLayer = NO_DEFERRED_LAYER;
+    items.swap(deferredItems);
+    staging.swap(deferredStaging);
+    flush(target);
+}
+
+void RenderQueue::endFrame() {
+    // Неотрисованное к концу кадра выбрасываем, чтобы не копилось
+    items.clear();
+    staging.clear();
+    deferredItems.clear();
+    deferredStaging.clear();
+    deferredLayer = NO_DEFERRED_LAYER;
+
+    lastFrameStats = frameStats;
+    totals.submitted += frameStats.submitted;
+    totals.batched += frameStats.batched;
+    totals.drawCalls += frameStats.drawCalls;
+    totals.textureBinds += frameStats.textureBinds;
+    totals.vertices += frameStats.vertices;
+    totalFrames++;
+
+    frameStats = Stats();
+    anyDraw = false;
+    boundTexture = nullptr;
+}
+
+void RenderQueue::printStats(const std::string& label) const {
+    if (totalFrames == 0) return;
+
+    double frames = static_cast<double>(totalFrames);
+    std::cout << "RenderQueue [" << label << "]: " << totalFrames << " frames, per frame: "
+        << totals.submitted / frames << " submitted, "
+        << totals.batched / frames << " batched, "
+        << totals.drawCalls / frames << " draw calls, "
+        << totals.textureBinds / frames << " texture binds, "
+        << totals.vertices / frames << " vertices" << std::endl;
+}
+
+void RenderQueue::resetTotals() {
+    totals = Stats();
+    totalFrames = 0;
+}
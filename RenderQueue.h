@@ -0,0 +1,118 @@
+﻿// RenderQueue.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+class SdfText;
+class SdfFont;
+
+// Очередь отрисовки между сценами и окном.
+// Сцены отправляют объекты со слоем и ключом сортировки; flush() упорядочивает их
+// по (слой, ключ, текстура, тип примитива) и склеивает совместимые квады в один поток вершин.
+// Порядок внутри слоя определяет только ключ: объекты с одинаковым ключом группируются по текстуре
+class RenderQueue {
+public:
+    struct Stats {
+        std::size_t submitted = 0;
+        std::size_t batched = 0;       // объекты, ушедшие в общий поток вершин
+        std::size_t drawCalls = 0;
+        std::size_t textureBinds = 0;  // смены текстуры между соседними вызовами draw
+        std::size_t vertices = 0;
+    };
+
+    // Слои по умолчанию для сцен: фон рисует GlitchRenderer, поверх — карточки и рамки, затем текст
+    enum Layer : int {
+        LAYER_BACKGROUND = 0,
+        LAYER_WIDGETS = 10,
+        LAYER_TEXT = 20
+    };
+
+    static RenderQueue& instance();
+
+    // Спрайты, прямоугольники и обычный текст раскладываются в вершины сразу при отправке,
+    // поэтому объект можно менять или удалять до flush()
+    void submit(const sf::Sprite& sprite, int layer = 0, std::int32_t sortKey = 0);
+    void submit(const sf::RectangleShape& shape, int layer = 0, std::int32_t sortKey = 0);
+    void submit(const sf::Text& text, int layer = 0, std::int32_t sortKey = 0);
+
+    // SdfText тоже уходит вершинами: надписи одного шрифта и одного экранного размера
+    // рисуются одним вызовом с общим шейдером сглаживания
+    void submit(const SdfText& text, int layer = 0, std::int32_t sortKey = 0);
+
+    // Копия надписи со сдвигом и другим цветом (призраки глитча) — те же вершины в том же пакете.
+    // false, если у шрифта нет атласа: тогда призрака рисует вызывающий
+    bool submitGhost(const SdfText& text, sf::Vector2f offset, sf::Color color, int layer = 0, std::int32_t sortKey = 0);
+
+    // Остальное (шейдеры, свои Drawable) рисуется как есть в своей позиции очереди.
+    // Объект должен жить до flush(); texture — подсказка для группировки
+    void submit(const sf::Drawable& drawable, int layer, std::int32_t sortKey,
+        const sf::Texture* texture, const sf::RenderStates& states = sf::RenderStates::Default);
+
+    void flush(sf::RenderTarget& target);
+
+    // Слои от layer и выше flush() не рисует, а придерживает до flushDeferred(): так текст
+    // минует уменьшенную цель ResolutionScaler и попадает в окно в родном разрешении
+    void deferLayersFrom(int layer);
+    void flushDeferred(sf::RenderTarget& target);
+
+    // Закрывает кадр: счетчики уходят в getLastFrameStats() и в сумму по сцене
+    void endFrame();
+    const Stats& getLastFrameStats() const { return lastFrameStats; }
+
+    // Средние за кадр с последнего resetTotals()
+    void printStats(const std::string& label) const;
+    void resetTotals();
+
+    // Геометрия sf::Text в треугольниках, как ее строит сам SFML (кернинг, межбуквенный и межстрочный интервалы)
+    static void appendTextQuads(const sf::Text& text, const sf::Transform& transform, sf::Color color, std::vector<sf::Vertex>& out);
+
+private:
+    struct Item {
+        int layer = 0;
+        std::int32_t sortKey = 0;
+        const sf::Texture* texture = nullptr;
+        std::uint32_t sequence = 0;
+
+        // Квады лежат в staging[firstVertex, firstVertex + vertexCount)
+        std::size_t firstVertex = 0;
+        std::size_t vertexCount = 0;
+
+        // Квады SdfText: шейдер шрифта с этим масштабом сглаживания
+        const SdfFont* sdfFont = nullptr;
+        float sdfScale = 0.f;
+
+        // Для объектов, которые рисуются сами
+        const sf::Drawable* drawable = nullptr;
+        sf::RenderStates states;
+    };
+
+    Item& pushItem(int layer, std::int32_t sortKey, const sf::Texture* texture);
+    void appendQuad(sf::Vector2f p0, sf::Vector2f p1, sf::Vector2f p2, sf::Vector2f p3, sf::Color color,
+        sf::FloatRect texRect = {});
+    void drawVertices(sf::RenderTarget& target, const Item& batch, std::size_t first, std::size_t count);
+    void countBind(const sf::Texture* texture);
+
+    // Все буферы переиспользуются между кадрами
+    std::vector<Item> items;
+    std::vector<std::uint32_t> order;
+    std::vector<sf::Vertex> staging;
+    std::vector<sf::Vertex> stream;
+
+    const sf::Texture* boundTexture = nullptr;
+    bool anyDraw = false;
+
+    static constexpr int NO_DEFERRED_LAYER = std::numeric_limits<int>::max();
+    int deferredLayer = NO_DEFERRED_LAYER;
+    std::vector<Item> deferredItems;
+    std::vector<sf::Vertex> deferredStaging;
+    void deferItems();
+
+    Stats frameStats;
+    Stats lastFrameStats;
+    Stats totals;
+    std::size_t totalFrames = 0;
+};
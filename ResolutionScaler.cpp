@@ -0,0 +1,68 @@
+﻿#include "ResolutionScaler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+ResolutionScaler& ResolutionScaler::instance() {
+    static ResolutionScaler scaler;
+    return scaler;
+}
+
+float ResolutionScaler::clampScale(float value) {
+    if (!(value > 0.f)) return MAX_SCALE;
+    return std::clamp(value, MIN_SCALE, MAX_SCALE);
+}
+
+void ResolutionScaler::configure(const GameConfig& config) {
+    scale = clampScale(config.renderScale);
+    targetFailed = false;
+    std::cout << "ResolutionScaler: render scale " << std::lround(scale * 100.f) << "%" << std::endl;
+}
+
+sf::RenderTarget& ResolutionScaler::beginFrame(sf::RenderWindow& window, bool postProcess) {
+    composing = false;
+    auto windowSize = window.getSize();
+    if ((scale >= MAX_SCALE && !postProcess) || targetFailed || windowSize.x == 0 || windowSize.y == 0) return window;
+
+    sf::Vector2u size(
+        std::max(1u, static_cast<unsigned int>(std::lround(windowSize.x * scale))),
+        std::max(1u, static_cast<unsigned int>(std::lround(windowSize.y * scale))));
+
+    if (!sceneTarget) {
+        sceneTarget = std::make_unique<sf::RenderTexture>();
+    }
+    if (sceneTarget->getSize() != size) {
+        if (!sceneTarget->resize(size)) {
+            // Без внутренней цели кадр идет прямо в окно: в родном разрешении и со спрайтовым глитчем.
+            // Повторная попытка — только после новой настройки
+            std::cerr << "ResolutionScaler: could not create " << size.x << "x" << size.y
+                << " scene target, rendering to the window" << std::endl;
+            sceneTarget.reset();
+            targetFailed = true;
+            return window;
+        }
+        sceneTarget->setSmooth(true);
+    }
+
+    // Тот же вид холста, что у окна: сцены рисуют в тех же координатах, меньше только пикселей
+    sceneTarget->setView(window.getView());
+    sceneTarget->clear();
+    composing = true;
+    return *sceneTarget;
+}
+
+void ResolutionScaler::present(sf::RenderWindow& window, const sf::Shader* shader) {
+    if (!composing) return;
+    composing = false;
+    sceneTarget->display();
+
+    sf::Vector2f windowSize(window.getSize());
+    sf::Vector2f targetSize(sceneTarget->getSize());
+    sf::Sprite upscaled(sceneTarget->getTexture());
+    upscaled.setScale(sf::Vector2f(windowSize.x / targetSize.x, windowSize.y / targetSize.y));
+
+    sf::View sceneView = window.getView();
+    window.setView(sf::View(sf::FloatRect({ 0.f, 0.f }, windowSize)));
+    window.draw(upscaled, shader);
+    window.setView(sceneView);
+}
@@ -0,0 +1,40 @@
+﻿// ResolutionScaler.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include "Config.h"
+
+// Сцена (фон, карточки, оверлей) рисуется во внутреннюю RenderTexture размером в долю окна
+// и растягивается на окно одним проходом; тот же проход делает постобработку глитча. Слой текста
+// RenderQueue во внутреннюю цель не идет: SceneManager дорисовывает его в окно после present(),
+// в родном разрешении
+class ResolutionScaler {
+public:
+    static constexpr float MIN_SCALE = 0.5f;
+    static constexpr float MAX_SCALE = 1.0f;
+
+    static ResolutionScaler& instance();
+
+    // Доля задается настройкой Render Scale и меняется только вместе с конфигом
+    void configure(const GameConfig& config);
+
+    float getScale() const { return scale; }
+
+    static float clampScale(float value);
+
+    // Цель кадра: при доле меньше 1 или для постобработки — внутренняя текстура с видом холста,
+    // иначе само окно
+    sf::RenderTarget& beginFrame(sf::RenderWindow& window, bool postProcess);
+
+    // Растягивает нарисованное во внутреннюю текстуру на окно, с шейдером — через него;
+    // если кадр шел прямо в окно, ничего не делает
+    void present(sf::RenderWindow& window, const sf::Shader* shader = nullptr);
+
+    bool isComposing() const { return composing; }
+
+private:
+    float scale = MAX_SCALE;
+    bool composing = false;
+    bool targetFailed = false;
+    std::unique_ptr<sf::RenderTexture> sceneTarget;
+};
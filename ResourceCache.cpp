@@ -0,0 +1,212 @@
+﻿#include "ResourceCache.h"
+#include "AssetArchive.h"
+#include "AssetManifest.h"
+#include "SdfFont.h"
+#include <iostream>
+
+ResourceCache& ResourceCache::instance() {
+    static ResourceCache cache;
+    return cache;
+}
+
+std::vector<std::string> ResourceCache::candidatePaths(const std::string& id) const {
+    // Путь уже разрешен манифестом при старте, перебора кандидатов здесь нет
+    auto& manifest = AssetManifest::instance();
+    if (auto path = manifest.resolve(id)) {
+        return { *path };
+    }
+
+    // Известный ID без файла: открывать нечего
+    if (manifest.isKnown(id)) {
+        return {};
+    }
+
+    // Неизвестный ID считаем прямым путем к файлу
+    return { id };
+}
+
+std::shared_ptr<sf::Font> ResourceCache::getFont(const std::string& id) {
+    auto it = fonts.find(id);
+    if (it != fonts.end()) {
+        stats.hits++;
+        return it->second;
+    }
+
+    stats.misses++;
+    auto font = std::make_shared<sf::Font>();
+    auto& archive = AssetArchive::instance();
+    bool loaded = false;
+    for (const auto& path : candidatePaths(id)) {
+        // Шрифт читает прямо из отображенного архива; отображение живет до конца процесса
+        if (auto blob = archive.find(path)) {
+            loaded = font->openFromMemory(blob->data, blob->size);
+        }
+        else if (!archive.owns(path)) {
+            loaded = font->openFromFile(path);
+        }
+
+        if (loaded) {
+            std::cout << "ResourceCache: font '" << id << "' loaded from: " << path << std::endl;
+            break;
+        }
+    }
+
+    if (!loaded) {
+        std::cerr << "ResourceCache: could not load font '" << id << "'. Text may not display correctly." << std::endl;
+    }
+
+    fonts.emplace(id, font);
+    stats.fonts = fonts.size();
+    return font;
+}
+
+std::shared_ptr<sf::Texture> ResourceCache::getTexture(const std::string& id) {
+    auto it = textures.find(id);
+    if (it != textures.end()) {
+        stats.hits++;
+        return it->second;
+    }
+
+    stats.misses++;
+    auto texture = std::make_shared<sf::Texture>();
+    auto& archive = AssetArchive::instance();
+    bool loaded = false;
+    for (const auto& path : candidatePaths(id)) {
+        if (auto blob = archive.find(path)) {
+            loaded = texture->loadFromMemory(blob->data, blob->size);
+        }
+        else if (!archive.owns(path)) {
+            loaded = texture->loadFromFile(path);
+        }
+
+        if (loaded) {
+            std::cout << "ResourceCache: texture '" << id << "' loaded from: " << path << std::endl;
+            break;
+        }
+    }
+
+    if (!loaded) {
+        std::cerr << "ResourceCache: could not load texture '" << id << "'" << std::endl;
+    }
+
+    textures.emplace(id, texture);
+    stats.textures = textures.size();
+    return texture;
+}
+
+std::shared_ptr<SdfFont> ResourceCache::getSdfFont(const std::string& id) {
+    auto it = sdfFonts.find(id);
+    if (it != sdfFonts.end()) {
+        stats.hits++;
+        return it->second;
+    }
+
+    stats.misses++;
+    auto font = std::make_shared<SdfFont>(id, getFont(id));
+    sdfFonts.emplace(id, font);
+    return font;
+}
+
+void ResourceCache::adoptTexture(const std::string& id, const sf::Image& image) {
+    if (hasTexture(id)) return;
+
+    auto texture = std::make_shared<sf::Texture>();
+    if (image.getSize().x > 0 && !texture->loadFromImage(image)) {
+        std::cerr << "ResourceCache: GPU upload failed for '" << id << "'" << std::endl;
+    }
+
+    textures.emplace(id, texture);
+    stats.preloaded++;
+    stats.textures = textures.size();
+}
+
+void ResourceCache::adoptFont(const std::string& id, const void* mappedData, std::size_t size) {
+    if (hasFont(id)) return;
+
+    // Данные лежат в отображении AssetArchive, копировать их не нужно
+    auto font = std::make_shared<sf::Font>();
+    if (!font->openFromMemory(mappedData, size)) {
+        std::cerr << "ResourceCache: could not open font '" << id << "' from archive" << std::endl;
+    }
+
+    fonts.emplace(id, font);
+    stats.preloaded++;
+    stats.fonts = fonts.size();
+}
+
+void ResourceCache::adoptFont(const std::string& id, std::vector<std::uint8_t>&& bytes) {
+    if (hasFont(id)) return;
+
+    // sf::Font читает данные лениво, поэтому байты живут вместе со шрифтом
+    struct FontWithData {
+        std::vector<std::uint8_t> data;
+        sf::Font font;
+    };
+
+    auto holder = std::make_shared<FontWithData>();
+    holder->data = std::move(bytes);
+    if (!holder->data.empty() && !holder->font.openFromMemory(holder->data.data(), holder->data.size())) {
+        std::cerr << "ResourceCache: could not open font '" << id << "' from memory" << std::endl;
+    }
+
+    fonts.emplace(id, std::shared_ptr<sf::Font>(holder, &holder->font));
+    stats.preloaded++;
+    stats.fonts = fonts.size();
+}
+
+bool ResourceCache::hasFont(const std::string& id) const {
+    return fonts.find(id) != fonts.end();
+}
+
+bool ResourceCache::hasTexture(const std::string& id) const {
+    return textures.find(id) != textures.end();
+}
+
+std::size_t ResourceCache::trim() {
+    std::size_t released = 0;
+
+    // SDF-шрифты держат свои sf::Font, поэтому освобождаются первыми
+    for (auto it = sdfFonts.begin(); it != sdfFonts.end();) {
+        if (it->second.use_count() == 1) {
+            it = sdfFonts.erase(it);
+            released++;
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for (auto it = fonts.begin(); it != fonts.end();) {
+        if (it->second.use_count() == 1) {
+            it = fonts.erase(it);
+            released++;
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for (auto it = textures.begin(); it != textures.end();) {
+        if (it->second.use_count() == 1) {
+            it = textures.erase(it);
+            released++;
+        }
+        else {
+            ++it;
+        }
+    }
+
+    stats.fonts = fonts.size();
+    stats.textures = textures.size();
+    return released;
+}
+
+void ResourceCache::resetCounters() {
+    stats.hits = 0;
+    stats.misses = 0;
+}
+
+void ResourceCache::printStats() const {
+    std::cout << "ResourceCache: hits " << stats.hits << ", misses " << stats.misses
+        << ", preloaded " << stats.preloaded << ", fonts " << stats.fonts << ", textures " << stats.textures << std::endl;
+}
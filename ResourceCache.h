@@ -0,0 +1,64 @@
+﻿// ResourceCache.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class SdfFont;
+
+// Общий кэш шрифтов и текстур на весь процесс.
+// Сцены получают shared_ptr по логическому ID ("font.ui", "tex.menu") и держат его,
+// пока живут; повторный запрос того же ID не трогает диск.
+class ResourceCache {
+public:
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t preloaded = 0;
+        std::size_t fonts = 0;
+        std::size_t textures = 0;
+    };
+
+    static ResourceCache& instance();
+
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    // Всегда возвращают валидный указатель; если файл не найден,
+    // в кэше остается пустой ресурс, чтобы не повторять неудачные открытия
+    std::shared_ptr<sf::Font> getFont(const std::string& id);
+    std::shared_ptr<sf::Texture> getTexture(const std::string& id);
+
+    // Атлас полей расстояний поверх шрифта id; строится при первом запросе
+    std::shared_ptr<SdfFont> getSdfFont(const std::string& id);
+
+    bool hasFont(const std::string& id) const;
+    bool hasTexture(const std::string& id) const;
+
+    // Прием готовых данных от AssetLoader (только главный поток)
+    void adoptTexture(const std::string& id, const sf::Image& image);
+    void adoptFont(const std::string& id, std::vector<std::uint8_t>&& bytes);
+    void adoptFont(const std::string& id, const void* mappedData, std::size_t size);
+
+    // Путь из AssetManifest (пусто, если файла нет); неизвестный ID считается путем к файлу
+    std::vector<std::string> candidatePaths(const std::string& id) const;
+
+    // Освобождает ресурсы, которые больше никто не держит
+    std::size_t trim();
+
+    const Stats& getStats() const { return stats; }
+    void resetCounters();
+    void printStats() const;
+
+private:
+    ResourceCache() = default;
+
+    std::unordered_map<std::string, std::shared_ptr<sf::Font>> fonts;
+    std::unordered_map<std::string, std::shared_ptr<sf::Texture>> textures;
+    std::unordered_map<std::string, std::shared_ptr<SdfFont>> sdfFonts;
+    Stats stats;
+};
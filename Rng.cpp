@@ -0,0 +1,71 @@
+﻿#include "Rng.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+    std::uint64_t splitMix64(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+void RngStream::reseed(std::uint64_t seed) {
+    for (auto& word : state) {
+        word = splitMix64(seed);
+    }
+}
+
+void RngStream::fill(std::uint32_t* out, std::size_t count) {
+    // Из одного 64-битного шага берем два числа
+    std::size_t i = 0;
+    for (; i + 1 < count; i += 2) {
+        std::uint64_t value = next();
+        out[i] = static_cast<std::uint32_t>(value >> 32);
+        out[i + 1] = static_cast<std::uint32_t>(value);
+    }
+    if (i < count) {
+        out[i] = nextU32();
+    }
+}
+
+void RngStream::fill(float* out, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = nextFloat();
+    }
+}
+
+Rng& Rng::instance() {
+    static Rng rng;
+    return rng;
+}
+
+Rng::Rng() {
+    std::uint64_t initial = 0;
+    const char* fromEnv = std::getenv(SEED_ENV);
+    if (fromEnv && *fromEnv) {
+        initial = std::strtoull(fromEnv, nullptr, 0);
+    }
+    else {
+        // random_device только здесь, один раз за процесс
+        std::random_device device;
+        initial = (static_cast<std::uint64_t>(device()) << 32) ^ device()
+            ^ static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    seed(initial);
+    std::cout << "Rng: seed " << masterSeed << " (set " << SEED_ENV << " to reproduce)" << std::endl;
+}
+
+void Rng::seed(std::uint64_t value) {
+    masterSeed = value;
+
+    std::uint64_t mixer = value;
+    for (auto& stream : streams) {
+        stream.reseed(splitMix64(mixer));
+    }
+}
@@ -0,0 +1,98 @@
+﻿// Rng.h
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Быстрый детерминированный генератор xoshiro256** для визуальных эффектов и геймплея.
+// Совместим с UniformRandomBitGenerator, так что работает и со стандартными распределениями.
+class RngStream {
+public:
+    using result_type = std::uint64_t;
+
+    explicit RngStream(std::uint64_t seed = 0) { reseed(seed); }
+
+    // Состояние расширяется через splitmix64, любой seed (включая 0) дает рабочее состояние
+    void reseed(std::uint64_t seed);
+
+    std::uint64_t next() {
+        std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    std::uint32_t nextU32() { return static_cast<std::uint32_t>(next() >> 32); }
+
+    // [0, bound); bound <= 0 дает 0, чтобы не повторять деление на ноль из rand() % n
+    int nextInt(int bound) { return bound > 0 ? static_cast<int>(bounded(nextU32(), static_cast<std::uint32_t>(bound))) : 0; }
+
+    // [low, high] включительно
+    int range(int low, int high) { return high > low ? low + nextInt(high - low + 1) : low; }
+
+    // [0, 1)
+    float nextFloat() { return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f); }
+    float range(float low, float high) { return low + (high - low) * nextFloat(); }
+    bool chance(float probability) { return nextFloat() < probability; }
+
+    // Пакетное заполнение для покадровых эффектов: один вызов вместо десятков
+    void fill(std::uint32_t* out, std::size_t count);
+    void fill(float* out, std::size_t count);
+
+    // Отображение сырого числа из fill() в [0, bound) без деления (Lemire)
+    static std::uint32_t bounded(std::uint32_t raw, std::uint32_t bound) {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(raw) * bound) >> 32);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    result_type operator()() { return next(); }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    std::array<std::uint64_t, 4> state{};
+};
+
+// Отдельный поток на подсистему: количество вызовов в одной не сдвигает последовательность другой
+enum class RngStreamId {
+    Glitch = 0,
+    Splash,
+    Appearance,
+    Gameplay,
+    // Случайность отрисовки глитча: кадров на шаг update() бывает от 0 до 8, поэтому
+    // она не должна тянуть числа из Glitch, иначе последовательность зависит от частоты кадров
+    GlitchVisual,
+    COUNT
+};
+
+// Процессный сервис случайных чисел с одним общим seed.
+// Seed берется из переменной окружения NEUROCIPHER_SEED, иначе случайный; он всегда пишется в лог,
+// чтобы прогон бенчмарка или запись кадров можно было повторить
+class Rng {
+public:
+    static constexpr const char* SEED_ENV = "NEUROCIPHER_SEED";
+
+    static Rng& instance();
+
+    Rng(const Rng&) = delete;
+    Rng& operator=(const Rng&) = delete;
+
+    // Пересевает все потоки; каждый получает свой seed, производный от общего
+    void seed(std::uint64_t masterSeed);
+    std::uint64_t getSeed() const { return masterSeed; }
+
+    RngStream& stream(RngStreamId id) { return streams[static_cast<std::size_t>(id)]; }
+
+private:
+    Rng();
+
+    std::uint64_t masterSeed = 0;
+    std::array<RngStream, static_cast<std::size_t>(RngStreamId::COUNT)> streams;
+};
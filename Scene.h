@@ -1,12 +1,60 @@
-//scene.h
+﻿//scene.h
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <utility>
+#include "SceneTransition.h"
+
+struct InputSnapshot;
 
 class Scene {
 public:
     virtual ~Scene() = default;
     virtual void update(float dt, sf::RenderWindow& window) = 0;
-    virtual void render(sf::RenderWindow& window) = 0;
+    virtual void render(sf::RenderTarget& target) = 0;
     virtual void handleEvent(const sf::Event& event, sf::RenderWindow& window) = 0;
-    virtual bool isFinished() const = 0;
+
+    // Вызывается раз в отрисованный кадр после разбора очереди событий. Действия в снимке
+    // относятся к этому кадру, поэтому каждое видно ровно один раз
+    virtual void handleInput(const InputSnapshot& input) {}
+
+    // Забирается SceneManager после update(); побеждает последний запрос кадра
+    SceneTransition takeTransition() { return std::exchange(pendingTransition, SceneTransition{}); }
+
+    // Статичные сцены перерисовываются только после invalidate() (ввод, завершенные загрузки,
+    // своя анимация); анимированные — каждый кадр
+    virtual bool isStatic() const { return false; }
+    void invalidate() { redrawRequested = true; }
+
+    // Вызывается SceneManager раз в кадр; снимает ожидающий запрос перерисовки
+    bool consumeRedraw() {
+        bool redraw = redrawRequested || !isStatic();
+        redrawRequested = false;
+        return redraw;
+    }
+
+    // Раскладывает виджеты на виртуальном холсте 1280x720. SceneManager вызывает его перед первым
+    // update(), а дальше только при изменении размера или пересоздании окна
+    virtual void layout(sf::RenderWindow& window) {}
+    void invalidateLayout() { layoutRequested = true; }
+
+    bool consumeLayout() {
+        bool requested = layoutRequested;
+        layoutRequested = false;
+        return requested;
+    }
+
+    // Ставится SceneManager перед render(): где кадр лежит между двумя последними фиксированными шагами
+    void setInterpolationAlpha(float alpha) { interpolationAlpha = alpha; }
+
+protected:
+    float getInterpolationAlpha() const { return interpolationAlpha; }
+
+    // Сцены называют, куда идти дальше; SceneManager строит цель через SceneRegistry
+    void requestTransition(SceneTransition transition) { pendingTransition = std::move(transition); }
+
+private:
+    bool redrawRequested = true;
+    bool layoutRequested = true;
+    float interpolationAlpha = 1.f;
+    SceneTransition pendingTransition;
 };
\ No newline at end of file
@@ -9,98 +9,179 @@
 #include "CharacterSpecializationScene.h"
 #include "CharacterFreePointsDistributionScene.h"  // Добавим include
 #include "CharacterAppearance.h"  // Добавим include
+#include "ResourceCache.h"
+#include "RenderQueue.h"
+#include "GlitchRenderer.h"
+#include "SceneRegistry.h"
+#include "ResolutionScaler.h"
+
+namespace {
+    // Единственное место, где перечислены типы сцен; новая сцена — одна строка здесь
+    void registerScenes(SceneRegistry& registry) {
+        registry.add(SceneId::Splash, "SplashScene", [](GameConfig&, const SceneParams&) {
+            return std::make_unique<SplashScene>();
+            });
+        registry.add(SceneId::MainMenu, "MainMenuScene", [](GameConfig& config, const SceneParams&) {
+            return std::make_unique<MainMenuScene>(config);
+            });
+        registry.add(SceneId::Settings, "SettingsScene", [](GameConfig& config, const SceneParams&) {
+            return std::make_unique<SettingsScene>(config);
+            });
+        registry.add(SceneId::CharacterOrigin, "CharacterOrigin", [](GameConfig& config, const SceneParams& params) {
+            return std::make_unique<CharacterOrigin>(config, params);
+            });
+        registry.add(SceneId::CharacterSpecialization, "CharacterSpecialization", [](GameConfig& config, const SceneParams& params) {
+            return std::make_unique<CharacterSpecialization>(config, params);
+            });
+        registry.add(SceneId::FreePoints, "FreePoints", [](GameConfig& config, const SceneParams& params) {
+            return std::make_unique<FreePoints>(config, params);
+            });
+        registry.add(SceneId::Appearance, "AppearanceScene", [](GameConfig& config, const SceneParams& params) {
+            return std::make_unique<AppearanceScene>(config, params);
+            });
+    }
+}
 
 SceneManager::SceneManager(const GameConfig& config) : config(config) {
-    currentScene = std::make_unique<SplashScene>();
+    registerScenes(SceneRegistry::instance());
+    scenes.push_back(createScene(SceneId::Splash, {}));
+}
+
+Scene* SceneManager::current() const {
+    return scenes.empty() ? nullptr : scenes.back().scene.get();
+}
+
+SceneManager::SceneEntry SceneManager::createScene(SceneId id, const SceneParams& params) {
+    auto scene = SceneRegistry::instance().create(id, config, params);
+    if (!scene) {
+        // Незарегистрированная сцена — fallback в главное меню, как раньше
+        std::cout << "SceneManager: unknown scene requested, returning to main menu" << std::endl;
+        id = SceneId::MainMenu;
+        scene = std::make_unique<MainMenuScene>(config);
+    }
+    return { id, std::move(scene) };
 }
 
 void SceneManager::update(float dt, sf::RenderWindow& window) {
-    if (currentScene) {
-        currentScene->update(dt, window);
-        if (currentScene->isFinished()) {
-            // SplashScene переходит в MainMenuScene
-            if (dynamic_cast<SplashScene*>(currentScene.get())) {
-                currentScene = std::make_unique<MainMenuScene>(config);
-            }
-            // MainMenuScene может отдавать следующую сцену
-            else if (auto* mainMenu = dynamic_cast<MainMenuScene*>(currentScene.get())) {
-                auto nextScene = mainMenu->extractNextScene();
-                if (nextScene) {
-                    currentScene = std::move(nextScene);
-                }
-                else {
-                    currentScene.reset();
-                }
-            }
-            // SettingsScene — возврат в главное меню после обновления
-            else if (dynamic_cast<SettingsScene*>(currentScene.get())) {
-                config = ConfigManager::load();
-                if (game) {
-                    game->updateWindow();
-                }
-                currentScene = std::make_unique<MainMenuScene>(config);
-            }
-            // Обработка CharacterOrigin
-            else if (auto* origin = dynamic_cast<CharacterOrigin*>(currentScene.get())) {
-                auto nextScene = origin->extractNextScene();
-                if (nextScene) {
-                    currentScene = std::move(nextScene);
-                }
-                else {
-                    currentScene = std::make_unique<MainMenuScene>(config);
-                }
-            }
-            // Обработка CharacterSpecialization
-            else if (auto* specialization = dynamic_cast<CharacterSpecialization*>(currentScene.get())) {
-                auto nextScene = specialization->extractNextScene();
-                if (nextScene) {
-                    currentScene = std::move(nextScene);
-                }
-                else {
-                    currentScene = std::make_unique<MainMenuScene>(config);
-                }
-            }
-            // ДОБАВЛЯЕМ: Обработка FreePoints
-            else if (auto* freePoints = dynamic_cast<FreePoints*>(currentScene.get())) {
-                auto nextScene = freePoints->extractNextScene();
-                if (nextScene) {
-                    std::cout << "SceneManager: Transitioning from FreePoints to next scene" << std::endl;
-                    currentScene = std::move(nextScene);
-                }
-                else {
-                    std::cout << "SceneManager: No next scene from FreePoints, returning to main menu" << std::endl;
-                    currentScene = std::make_unique<MainMenuScene>(config);
-                }
-            }
-            // ДОБАВЛЯЕМ: Обработка AppearanceScene
-            else if (auto* appearance = dynamic_cast<AppearanceScene*>(currentScene.get())) {
-                auto nextScene = appearance->extractNextScene();
-                if (nextScene) {
-                    std::cout << "SceneManager: Transitioning from AppearanceScene to next scene" << std::endl;
-                    currentScene = std::move(nextScene);
-                }
-                else {
-                    std::cout << "SceneManager: AppearanceScene completed, returning to main menu" << std::endl;
-                    currentScene = std::make_unique<MainMenuScene>(config);
-                }
-            }
-            else {
-                // Для любых других сцен — fallback в главное меню
-                std::cout << "SceneManager: Unknown scene finished, returning to main menu" << std::endl;
-                currentScene = std::make_unique<MainMenuScene>(config);
-            }
+    Scene* scene = current();
+    if (!scene) return;
+
+    if (scene->consumeLayout()) {
+        scene->layout(window);
+    }
+    scene->update(dt, window);
+
+    // Переходы, запрошенные в handleEvent() или update(), применяются здесь
+    if (SceneTransition transition = scene->takeTransition()) {
+        applyTransition(std::move(transition));
+    }
+}
+
+void SceneManager::applyTransition(SceneTransition transition) {
+    auto& registry = SceneRegistry::instance();
+
+    // Запоминаем счетчик промахов, чтобы увидеть, читал ли переход что-то с диска
+    auto& cache = ResourceCache::instance();
+    std::size_t missesBefore = cache.getStats().misses;
+
+    // Итог отрисовки уходящей сцены: вызовы draw и смены текстур в среднем за кадр
+    const char* fromName = registry.getName(scenes.back().id);
+    auto& renderQueue = RenderQueue::instance();
+    renderQueue.printStats(fromName);
+    renderQueue.resetTotals();
+
+    // Выход из настроек: новый конфиг и окно до того, как откроется следующая сцена
+    if (transition.reloadConfig) {
+        config = ConfigManager::load();
+        if (game) {
+            game->updateWindow();
         }
     }
+
+    switch (transition.type) {
+    case SceneTransition::Type::Push:
+        scenes.push_back(createScene(transition.target, transition.params));
+        break;
+    case SceneTransition::Type::Replace:
+        // Новая сцена строится раньше, чем уходит старая: общие ресурсы кэша не выгружаются
+        scenes.back() = createScene(transition.target, transition.params);
+        break;
+    case SceneTransition::Type::Pop:
+        scenes.pop_back();
+        break;
+    case SceneTransition::Type::None:
+        break;
+    }
+
+    std::cout << "SceneManager: " << fromName << " -> "
+        << (scenes.empty() ? "none" : registry.getName(scenes.back().id));
+    for (const auto& [key, value] : transition.params) {
+        std::cout << " " << key << "=" << value;
+    }
+    std::cout << std::endl;
+
+    if (Scene* scene = current()) {
+        // Сцена из глубины стека могла пропустить ресайз, пока ждала
+        scene->invalidateLayout();
+        scene->invalidate();
+    }
+
+    std::cout << "SceneManager: transition cache misses: "
+        << cache.getStats().misses - missesBefore << std::endl;
+    cache.printStats();
 }
 
-void SceneManager::render(sf::RenderWindow& window) {
-    if (currentScene)
-        currentScene->render(window);
+void SceneManager::render(sf::RenderWindow& window, float alpha) {
+    auto& renderQueue = RenderQueue::instance();
+    auto& scaler = ResolutionScaler::instance();
+    GlitchRenderer::setInterpolationAlpha(alpha);
+
+    // Уменьшенный кадр или кадр под постобработку рисуется во внутреннюю цель,
+    // а текст придерживается до вывода в окно
+    sf::RenderTarget& target = scaler.beginFrame(window, GlitchRenderer::isShaderActive());
+    if (scaler.isComposing()) {
+        renderQueue.deferLayersFrom(RenderQueue::LAYER_TEXT);
+    }
+
+    if (Scene* scene = current()) {
+        // Сцена, только что созданная переходом, еще не раскладывалась
+        if (scene->consumeLayout()) {
+            scene->layout(window);
+        }
+        scene->setInterpolationAlpha(alpha);
+        scene->render(target);
+    }
+
+    // Досылаем то, что сцена не сбросила сама, растягиваем кадр и поверх рисуем текст
+    renderQueue.flush(target);
+    scaler.present(window, GlitchRenderer::preparePostProcess(window.getSize()));
+    renderQueue.flushDeferred(window);
+    renderQueue.endFrame();
+    GlitchRenderer::endFrame();
+}
+
+void SceneManager::invalidate() {
+    if (Scene* scene = current()) scene->invalidate();
+}
+
+void SceneManager::invalidateLayout() {
+    if (Scene* scene = current()) scene->invalidateLayout();
+}
+
+bool SceneManager::needsRedraw() {
+    Scene* scene = current();
+    return scene && scene->consumeRedraw();
+}
+
+void SceneManager::handleInput(const InputSnapshot& input) {
+    if (Scene* scene = current()) {
+        scene->handleInput(input);
+    }
 }
 
 void SceneManager::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
-    if (currentScene) {
-        currentScene->handleEvent(event, window);
+    if (Scene* scene = current()) {
+        scene->handleEvent(event, window);
     }
 }
 
@@ -1,7 +1,9 @@
 ﻿#pragma once
 #include <SFML/Graphics.hpp>
 #include <memory>
+#include <vector>
 #include "Scene.h" 
+#include "SceneTransition.h"
 #include <SFML/Config.hpp>
 #include <SFML/Window.hpp>
 #include "Config.h"
@@ -21,11 +23,22 @@ public:
     SceneManager& operator=(SceneManager&&) = default;
     
     void update(float deltaTime, sf::RenderWindow& window);
-    void render(sf::RenderWindow& window);
+    // alpha — доля кадра между двумя последними фиксированными шагами update()
+    void render(sf::RenderWindow& window, float alpha = 1.f);
     void handleEvent(const sf::Event& event, sf::RenderWindow& window);
+    // Снимок ввода за кадр — раз в кадр, после разбора очереди событий
+    void handleInput(const InputSnapshot& input);
 
+    // Просит текущую сцену перерисоваться; needsRedraw() снимает запрос
+    void invalidate();
+    bool needsRedraw();
+
+    // Окно изменило размер или пересоздано: сцена разложит виджеты заново перед update()
+    void invalidateLayout();
+
+    // Стек опустел — игре больше нечего показывать
     bool isFinished() const {
-        return !currentScene;
+        return scenes.empty();
     }
     
     GameConfig& getConfig() { return config; }
@@ -33,7 +46,17 @@ public:
 
 
 private:
-    std::unique_ptr<Scene> currentScene; 
+    struct SceneEntry {
+        SceneId id;
+        std::unique_ptr<Scene> scene;
+    };
+
+    // Верх стека — активная сцена; сцены ниже ждут Pop и не обновляются
+    std::vector<SceneEntry> scenes;
     GameConfig config;
     Game* game = nullptr;
+
+    Scene* current() const;
+    void applyTransition(SceneTransition transition);
+    SceneEntry createScene(SceneId id, const SceneParams& params);
 };
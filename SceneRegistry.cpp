@@ -0,0 +1,27 @@
+﻿// SceneRegistry.cpp
+#include "SceneRegistry.h"
+#include <iostream>
+
+SceneRegistry& SceneRegistry::instance() {
+    static SceneRegistry registry;
+    return registry;
+}
+
+void SceneRegistry::add(SceneId id, const char* name, Factory factory) {
+    Entry& entry = entries[static_cast<std::size_t>(id)];
+    entry.name = name;
+    entry.factory = std::move(factory);
+}
+
+std::unique_ptr<Scene> SceneRegistry::create(SceneId id, GameConfig& config, const SceneParams& params) const {
+    const Entry& entry = entries[static_cast<std::size_t>(id)];
+    if (!entry.factory) {
+        std::cerr << "SceneRegistry: no factory for scene " << static_cast<int>(id) << std::endl;
+        return nullptr;
+    }
+    return entry.factory(config, params);
+}
+
+const char* SceneRegistry::getName(SceneId id) const {
+    return entries[static_cast<std::size_t>(id)].name;
+}
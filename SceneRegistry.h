@@ -0,0 +1,34 @@
+﻿// SceneRegistry.h
+#pragma once
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "Scene.h"
+#include "SceneTransition.h"
+#include "Config.h"
+
+// Таблица фабрик сцен по SceneId. SceneManager строит сцены только через нее:
+// переход — один индекс в массиве, без RTTI и без перебора типов
+class SceneRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<Scene>(GameConfig& config, const SceneParams& params)>;
+
+    static SceneRegistry& instance();
+
+    // Повторная регистрация заменяет фабрику
+    void add(SceneId id, const char* name, Factory factory);
+
+    // nullptr, если для id ничего не зарегистрировано
+    std::unique_ptr<Scene> create(SceneId id, GameConfig& config, const SceneParams& params) const;
+
+    const char* getName(SceneId id) const;
+
+private:
+    struct Entry {
+        const char* name = "Unregistered";
+        Factory factory;
+    };
+
+    std::array<Entry, static_cast<std::size_t>(SceneId::Count)> entries;
+};
@@ -0,0 +1,55 @@
+﻿// SceneTransition.h
+#pragma once
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Идентификаторы сцен для SceneRegistry. Count — размер таблицы фабрик, не сцена
+enum class SceneId {
+    Splash,
+    MainMenu,
+    Settings,
+    CharacterOrigin,
+    CharacterSpecialization,
+    FreePoints,
+    Appearance,
+    Count
+};
+
+// Параметры для фабрики следующей сцены. Сцены создания персонажа хранят их как choices:
+// выбор на прошлых шагах ("save", "origin", "specialization"), каждая добавляет свой и передает дальше
+using SceneParams = std::unordered_map<std::string, std::string>;
+
+// Запрос сцены к SceneManager: что сделать со стеком сцен после текущего update()
+struct SceneTransition {
+    enum class Type {
+        None,
+        Push,     // новая сцена поверх, текущая ждет в стеке
+        Pop,      // вернуться к сцене ниже; пустой стек завершает игру
+        Replace   // текущая сцена уничтожается, на ее место встает новая
+    };
+
+    Type type = Type::None;
+    SceneId target = SceneId::MainMenu;
+    SceneParams params;
+
+    // Перечитать конфиг и пересоздать окно до перехода (выход из настроек)
+    bool reloadConfig = false;
+
+    static SceneTransition push(SceneId target, SceneParams params = {}) {
+        return { Type::Push, target, std::move(params) };
+    }
+
+    static SceneTransition replace(SceneId target, SceneParams params = {}) {
+        return { Type::Replace, target, std::move(params) };
+    }
+
+    static SceneTransition pop() {
+        SceneTransition transition;
+        transition.type = Type::Pop;
+        return transition;
+    }
+
+    explicit operator bool() const { return type != Type::None; }
+};
@@ -0,0 +1,277 @@
+﻿#include "SdfFont.h"
+#include "AssetManifest.h"
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+    constexpr float EDT_INF = 1e20f;
+    constexpr int CACHE_VERSION = 1;
+
+    // GLSL 1.10, чтобы работать и на старых драйверах
+    const char* SDF_FRAGMENT_SHADER = R"(#version 110
+uniform sampler2D texture;
+uniform float smoothing;
+uniform vec4 tint;
+uniform float useTint;
+
+void main() {
+    float distance = texture2D(texture, gl_TexCoord[0].xy).a;
+    float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+    vec4 color = mix(gl_Color, tint, useTint);
+    gl_FragColor = vec4(color.rgb, color.a * alpha);
+}
+)";
+
+    // Одномерное точное преобразование расстояний (Felzenszwalb & Huttenlocher), квадраты расстояний
+    void distanceTransform1d(const float* f, float* d, int* v, float* z, int n) {
+        int k = 0;
+        v[0] = 0;
+        z[0] = -EDT_INF;
+        z[1] = EDT_INF;
+
+        for (int q = 1; q < n; ++q) {
+            float s = ((f[q] + float(q * q)) - (f[v[k]] + float(v[k] * v[k]))) / float(2 * q - 2 * v[k]);
+            while (s <= z[k]) {
+                --k;
+                s = ((f[q] + float(q * q)) - (f[v[k]] + float(v[k] * v[k]))) / float(2 * q - 2 * v[k]);
+            }
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = EDT_INF;
+        }
+
+        k = 0;
+        for (int q = 0; q < n; ++q) {
+            while (z[k + 1] < float(q)) ++k;
+            float delta = float(q - v[k]);
+            d[q] = delta * delta + f[v[k]];
+        }
+    }
+
+    // Двумерный вариант: сначала столбцы, потом строки
+    void distanceTransform2d(std::vector<float>& grid, int width, int height) {
+        int n = std::max(width, height);
+        std::vector<float> f(n), d(n), z(n + 1);
+        std::vector<int> v(n);
+
+        for (int x = 0; x < width; ++x) {
+            for (int y = 0; y < height; ++y) f[y] = grid[y * width + x];
+            distanceTransform1d(f.data(), d.data(), v.data(), z.data(), height);
+            for (int y = 0; y < height; ++y) grid[y * width + x] = d[y];
+        }
+
+        for (int y = 0; y < height; ++y) {
+            std::copy_n(grid.begin() + y * width, width, f.begin());
+            distanceTransform1d(f.data(), d.data(), v.data(), z.data(), width);
+            std::copy_n(d.begin(), width, grid.begin() + y * width);
+        }
+    }
+}
+
+SdfFont::SdfFont(const std::string& id, std::shared_ptr<sf::Font> source) : source(std::move(source)) {
+    compileShader();
+    if (!shaderReady) {
+        std::cout << "SdfFont: shaders unavailable, '" << id << "' falls back to sf::Text" << std::endl;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string sourcePath = AssetManifest::instance().resolve(id).value_or(id);
+    std::string basePath = std::string(CACHE_DIR) + id + ".sdf";
+
+    bool fromCache = loadCache(basePath, sourcePath);
+    if (!fromCache) {
+        glyphs.clear();
+        sf::Image image;
+        if (!generate(image)) {
+            std::cerr << "SdfFont: could not build distance field for '" << id << "'" << std::endl;
+            glyphs.clear();
+            return;
+        }
+        saveCache(basePath, sourcePath, image);
+    }
+
+    texture.setSmooth(true);
+    ready = true;
+
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "SdfFont: '" << id << "' " << (fromCache ? "loaded from cache" : "generated") << ", "
+        << glyphs.size() << " glyphs, " << texture.getSize().x << "x" << texture.getSize().y
+        << " in " << ms << " ms" << std::endl;
+}
+
+void SdfFont::compileShader() {
+    if (!sf::Shader::isAvailable()) return;
+
+    shaderReady = shader.loadFromMemory(SDF_FRAGMENT_SHADER, sf::Shader::Type::Fragment);
+    if (shaderReady) {
+        shader.setUniform("texture", sf::Shader::CurrentTexture);
+    }
+    else {
+        std::cerr << "SdfFont: fragment shader failed to compile" << std::endl;
+    }
+}
+
+bool SdfFont::generate(sf::Image& result) {
+    if (!source) return false;
+
+    // Сначала запрашиваем все глифы, чтобы они попали на одну страницу sf::Font, потом читаем ее один раз
+    std::vector<std::pair<char32_t, sf::Glyph>> raw;
+    for (char32_t code = FIRST_CHAR; code <= LAST_CHAR; ++code) {
+        raw.emplace_back(code, source->getGlyph(code, BASE_SIZE, false));
+    }
+
+    sf::Image page = source->getTexture(BASE_SIZE).copyToImage();
+    if (page.getSize().x == 0) return false;
+
+    lineSpacing = source->getLineSpacing(BASE_SIZE);
+    const std::uint8_t* pagePixels = page.getPixelsPtr();
+    const int pageWidth = static_cast<int>(page.getSize().x);
+    const int spread = static_cast<int>(SPREAD);
+
+    TextureAtlas atlas({ 512, 512 }, 1);
+    std::vector<float> toInside;
+    std::vector<float> toOutside;
+    std::vector<std::uint8_t> pixels;
+
+    for (const auto& [code, metrics] : raw) {
+        Glyph glyph;
+        glyph.advance = metrics.advance;
+
+        const sf::IntRect& rect = metrics.textureRect;
+        if (rect.size.x <= 0 || rect.size.y <= 0) {
+            glyphs[code] = glyph;
+            continue;
+        }
+
+        // Ячейка глифа с полями SPREAD, чтобы поле успевало спасть до нуля
+        int width = rect.size.x + 2 * spread;
+        int height = rect.size.y + 2 * spread;
+        toInside.assign(static_cast<std::size_t>(width) * height, EDT_INF);
+        toOutside.assign(static_cast<std::size_t>(width) * height, 0.f);
+
+        for (int y = 0; y < rect.size.y; ++y) {
+            for (int x = 0; x < rect.size.x; ++x) {
+                std::size_t pageIndex = (static_cast<std::size_t>(rect.position.y + y) * pageWidth + rect.position.x + x) * 4 + 3;
+                if (pagePixels[pageIndex] >= 128) {
+                    std::size_t index = static_cast<std::size_t>(y + spread) * width + x + spread;
+                    toInside[index] = 0.f;
+                    toOutside[index] = EDT_INF;
+                }
+            }
+        }
+
+        distanceTransform2d(toInside, width, height);
+        distanceTransform2d(toOutside, width, height);
+
+        // Снаружи расстояние положительное; 0.5 в альфе — контур глифа
+        pixels.assign(toInside.size() * 4, 255);
+        for (std::size_t i = 0; i < toInside.size(); ++i) {
+            float signedDistance = std::sqrt(toInside[i]) - std::sqrt(toOutside[i]);
+            float value = std::clamp(0.5f - signedDistance / (2.f * spread), 0.f, 1.f);
+            pixels[i * 4 + 3] = static_cast<std::uint8_t>(value * 255.f + 0.5f);
+        }
+
+        sf::Image cell(sf::Vector2u(static_cast<unsigned int>(width), static_cast<unsigned int>(height)), pixels.data());
+        auto placed = atlas.insert(cell);
+        if (!placed) return false;
+
+        glyph.textureRect = *placed;
+        glyph.bounds = sf::FloatRect(
+            { metrics.bounds.position.x - spread, metrics.bounds.position.y - spread },
+            { static_cast<float>(width), static_cast<float>(height) });
+        glyphs[code] = glyph;
+    }
+
+    if (!atlas.upload()) return false;
+    result = atlas.getTexture().copyToImage();
+    return texture.loadFromImage(result);
+}
+
+bool SdfFont::loadCache(const std::string& basePath, const std::string& sourcePath) {
+    std::ifstream in(basePath + ".txt");
+    if (!in) return false;
+
+    // Заголовок: версия формата, размеры и путь шрифта, из которого атлас построен
+    std::string magic;
+    int version = 0;
+    unsigned int baseSize = 0;
+    unsigned int spread = 0;
+    in >> magic >> version >> baseSize >> spread;
+    std::string cachedSource;
+    in >> std::ws;
+    std::getline(in, cachedSource);
+    if (magic != "NCSDF" || version != CACHE_VERSION || baseSize != BASE_SIZE || spread != SPREAD || cachedSource != sourcePath) {
+        std::cout << "SdfFont: cache " << basePath << " is stale, regenerating" << std::endl;
+        return false;
+    }
+
+    std::size_t count = 0;
+    in >> lineSpacing >> count;
+    for (std::size_t i = 0; i < count && in; ++i) {
+        std::uint32_t code = 0;
+        Glyph glyph;
+        in >> code >> glyph.advance
+            >> glyph.bounds.position.x >> glyph.bounds.position.y >> glyph.bounds.size.x >> glyph.bounds.size.y
+            >> glyph.textureRect.position.x >> glyph.textureRect.position.y >> glyph.textureRect.size.x >> glyph.textureRect.size.y;
+        glyphs[static_cast<char32_t>(code)] = glyph;
+    }
+
+    if (!in || glyphs.size() != count) return false;
+    return texture.loadFromFile(basePath + ".png");
+}
+
+void SdfFont::saveCache(const std::string& basePath, const std::string& sourcePath, const sf::Image& image) const {
+    std::error_code error;
+    std::filesystem::create_directories(CACHE_DIR, error);
+
+    if (!image.saveToFile(basePath + ".png")) {
+        std::cerr << "SdfFont: could not write " << basePath << ".png" << std::endl;
+        return;
+    }
+
+    std::ofstream out(basePath + ".txt");
+    out << "NCSDF " << CACHE_VERSION << " " << BASE_SIZE << " " << SPREAD << "\n";
+    out << sourcePath << "\n";
+    out << lineSpacing << " " << glyphs.size() << "\n";
+    for (const auto& [code, glyph] : glyphs) {
+        out << static_cast<std::uint32_t>(code) << " " << glyph.advance << " "
+            << glyph.bounds.position.x << " " << glyph.bounds.position.y << " "
+            << glyph.bounds.size.x << " " << glyph.bounds.size.y << " "
+            << glyph.textureRect.position.x << " " << glyph.textureRect.position.y << " "
+            << glyph.textureRect.size.x << " " << glyph.textureRect.size.y << "\n";
+    }
+}
+
+const SdfFont::Glyph& SdfFont::getGlyph(char32_t code) const {
+    auto it = glyphs.find(code);
+    if (it == glyphs.end()) {
+        it = glyphs.find(U'?');
+    }
+    return it != glyphs.end() ? it->second : missing;
+}
+
+const sf::Shader* SdfFont::getShader(float pixelScale, std::optional<sf::Color> tint) const {
+    if (!shaderReady) return nullptr;
+
+    // Цвет слоя без перестройки вершин: призраки глитча рисуются из той же геометрии
+    shader.setUniform("tint", tint.value_or(sf::Color::White));
+    shader.setUniform("useTint", tint ? 1.f : 0.f);
+
+    // Полоса сглаживания около 0.7 экранного пикселя: на пиксель BASE_SIZE поле меняется на 1/(2*SPREAD)
+    float smoothing = 0.7f / (2.f * SPREAD * std::max(pixelScale, 0.01f));
+    shader.setUniform("smoothing", std::clamp(smoothing, 0.005f, 0.25f));
+    return &shader;
+}
+
+std::size_t SdfFont::getTextureBytes() const {
+    auto size = texture.getSize();
+    return static_cast<std::size_t>(size.x) * size.y * 4;
+}
@@ -0,0 +1,60 @@
+﻿// SdfFont.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+// Шрифт в виде атласа полей расстояний (signed distance field).
+// Глифы растеризуются один раз в BASE_SIZE, поле расстояний сохраняется в cache/fonts/,
+// и дальше текст любого размера рисуется из этого атласа без новых страниц sf::Font.
+class SdfFont {
+public:
+    struct Glyph {
+        float advance = 0.f;
+        sf::FloatRect bounds;       // квад относительно пера, в пикселях BASE_SIZE, с учетом SPREAD
+        sf::IntRect textureRect;    // пусто для пробельных символов
+    };
+
+    static constexpr unsigned int BASE_SIZE = 48;
+    static constexpr unsigned int SPREAD = 6;
+    static constexpr char32_t FIRST_CHAR = 32;
+    static constexpr char32_t LAST_CHAR = 126;
+    static constexpr const char* CACHE_DIR = "cache/fonts/";
+
+    // Берет атлас из кэша на диске, а если его нет или он устарел — строит из source
+    SdfFont(const std::string& id, std::shared_ptr<sf::Font> source);
+
+    SdfFont(const SdfFont&) = delete;
+    SdfFont& operator=(const SdfFont&) = delete;
+
+    // false, если нет шейдеров или атлас построить не удалось; SdfText тогда рисует обычным sf::Text
+    bool isReady() const { return ready; }
+
+    const Glyph& getGlyph(char32_t code) const;
+    float getLineSpacing() const { return lineSpacing; }
+    const sf::Texture& getTexture() const { return texture; }
+    const std::shared_ptr<sf::Font>& getSourceFont() const { return source; }
+    std::size_t getTextureBytes() const;
+
+    // Шейдер порога по полю; pixelScale — сколько экранных пикселей приходится на пиксель BASE_SIZE.
+    // tint заменяет цвет вершин. nullptr, если шейдеры недоступны
+    const sf::Shader* getShader(float pixelScale, std::optional<sf::Color> tint = std::nullopt) const;
+
+private:
+    bool loadCache(const std::string& basePath, const std::string& sourcePath);
+    bool generate(sf::Image& result);
+    void saveCache(const std::string& basePath, const std::string& sourcePath, const sf::Image& image) const;
+    void compileShader();
+
+    std::shared_ptr<sf::Font> source;
+    std::unordered_map<char32_t, Glyph> glyphs;
+    Glyph missing;
+    float lineSpacing = 0.f;
+    sf::Texture texture;
+    mutable sf::Shader shader;
+    bool shaderReady = false;
+    bool ready = false;
+};
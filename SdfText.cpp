@@ -0,0 +1,180 @@
+﻿#include "SdfText.h"
+#include <algorithm>
+#include <cmath>
+
+SdfText::SdfText(std::shared_ptr<SdfFont> font, const std::string& string, unsigned int characterSize)
+    : font(std::move(font)), string(string), characterSize(characterSize) {
+    if (!this->font->isReady()) {
+        fallbackText.emplace(*this->font->getSourceFont(), string, characterSize);
+    }
+}
+
+void SdfText::setString(const std::string& value) {
+    if (value == string) return;
+
+    string = value;
+    geometryDirty = true;
+    if (fallbackText) fallbackText->setString(string);
+}
+
+void SdfText::setCharacterSize(unsigned int size) {
+    // Только масштаб при отрисовке, вершины остаются прежними
+    characterSize = size;
+    if (fallbackText) fallbackText->setCharacterSize(size);
+}
+
+void SdfText::setFillColor(sf::Color color) {
+    if (color == fillColor) return;
+
+    fillColor = color;
+    if (fallbackText) {
+        fallbackText->setFillColor(color);
+    }
+    else if (!geometryDirty) {
+        for (std::size_t i = 0; i < vertices.getVertexCount(); ++i) {
+            vertices[i].color = color;
+        }
+    }
+}
+
+float SdfText::getSizeScale() const {
+    return static_cast<float>(characterSize) / SdfFont::BASE_SIZE;
+}
+
+sf::FloatRect SdfText::getLocalBounds() const {
+    if (fallbackText) return fallbackText->getLocalBounds();
+
+    ensureGeometry();
+    float k = getSizeScale();
+    return sf::FloatRect(baseBounds.position * k, baseBounds.size * k);
+}
+
+sf::FloatRect SdfText::getGlobalBounds() const {
+    return getTransform().transformRect(getLocalBounds());
+}
+
+void SdfText::ensureGeometry() const {
+    if (!geometryDirty) return;
+    geometryDirty = false;
+
+    vertices.clear();
+    const float spread = static_cast<float>(SdfFont::SPREAD);
+    const float spaceAdvance = font->getGlyph(U' ').advance;
+
+    // Первая базовая линия на высоте размера символов, как у sf::Text
+    float x = 0.f;
+    float y = static_cast<float>(SdfFont::BASE_SIZE);
+    float minX = 0.f, minY = 0.f, maxX = 0.f, maxY = 0.f;
+    bool empty = true;
+
+    for (unsigned char c : string) {
+        if (c == '\n') {
+            x = 0.f;
+            y += font->getLineSpacing();
+            continue;
+        }
+        if (c == '\t') {
+            x += spaceAdvance * 4.f;
+            maxX = std::max(maxX, x);
+            continue;
+        }
+
+        const SdfFont::Glyph& glyph = font->getGlyph(static_cast<char32_t>(c));
+        if (glyph.textureRect.size.x > 0) {
+            float left = x + glyph.bounds.position.x;
+            float top = y + glyph.bounds.position.y;
+            float right = left + glyph.bounds.size.x;
+            float bottom = top + glyph.bounds.size.y;
+
+            float u1 = static_cast<float>(glyph.textureRect.position.x);
+            float v1 = static_cast<float>(glyph.textureRect.position.y);
+            float u2 = u1 + glyph.textureRect.size.x;
+            float v2 = v1 + glyph.textureRect.size.y;
+
+            vertices.append({ { left, top }, fillColor, { u1, v1 } });
+            vertices.append({ { right, top }, fillColor, { u2, v1 } });
+            vertices.append({ { left, bottom }, fillColor, { u1, v2 } });
+            vertices.append({ { left, bottom }, fillColor, { u1, v2 } });
+            vertices.append({ { right, top }, fillColor, { u2, v1 } });
+            vertices.append({ { right, bottom }, fillColor, { u2, v2 } });
+
+            // В границы идет сам глиф, без полей поля расстояний
+            if (empty) {
+                minX = left + spread;
+                minY = top + spread;
+                maxX = right - spread;
+                maxY = bottom - spread;
+                empty = false;
+            }
+            else {
+                minX = std::min(minX, left + spread);
+                minY = std::min(minY, top + spread);
+                maxX = std::max(maxX, right - spread);
+                maxY = std::max(maxY, bottom - spread);
+            }
+        }
+
+        x += glyph.advance;
+        if (c == ' ') maxX = std::max(maxX, x);
+    }
+
+    baseBounds = sf::FloatRect({ minX, minY }, { maxX - minX, maxY - minY });
+}
+
+void SdfText::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    drawWithColor(target, states, std::nullopt);
+}
+
+void SdfText::drawGhost(sf::RenderTarget& target, sf::Vector2f offset, sf::Color color) const {
+    sf::RenderStates states;
+    states.transform.translate(offset);
+    drawWithColor(target, states, color);
+}
+
+bool SdfText::appendVertices(std::vector<sf::Vertex>& out, sf::Vector2f offset, std::optional<sf::Color> color) const {
+    if (fallbackText) return false;
+
+    ensureGeometry();
+    float k = getSizeScale();
+    sf::Transform transform;
+    transform.translate(offset);
+    transform *= getTransform();
+    transform.scale({ k, k });
+
+    for (std::size_t i = 0; i < vertices.getVertexCount(); ++i) {
+        sf::Vertex vertex = vertices[i];
+        vertex.position = transform.transformPoint(vertex.position);
+        if (color) vertex.color = *color;
+        out.push_back(vertex);
+    }
+    return true;
+}
+
+float SdfText::getSmoothingScale() const {
+    sf::Vector2f scale = getScale();
+    return getSizeScale() * std::max(std::abs(scale.x), std::abs(scale.y));
+}
+
+void SdfText::drawWithColor(sf::RenderTarget& target, sf::RenderStates states, std::optional<sf::Color> color) const {
+    if (fallbackText) {
+        states.transform *= getTransform();
+        if (color) fallbackText->setFillColor(*color);
+        target.draw(*fallbackText, states);
+        if (color) fallbackText->setFillColor(fillColor);
+        return;
+    }
+
+    ensureGeometry();
+    if (vertices.getVertexCount() == 0) return;
+
+    float k = getSizeScale();
+    states.transform *= getTransform();
+    states.transform.scale({ k, k });
+    states.texture = &font->getTexture();
+
+    // Ширина сглаживания зависит от итогового размера на экране, включая масштаб вида
+    float viewScale = static_cast<float>(target.getSize().x) / target.getView().getSize().x;
+    states.shader = font->getShader(getSmoothingScale() * viewScale, color);
+
+    target.draw(vertices, states);
+}
@@ -0,0 +1,61 @@
+﻿// SdfText.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "SdfFont.h"
+
+// Замена sf::Text для интерфейса: геометрия строится один раз в единицах SdfFont::BASE_SIZE,
+// а размер символов применяется как масштаб при отрисовке. Смена размера
+// (например, при изменении окна) не перестраивает вершины и не растеризует глифы.
+class SdfText : public sf::Drawable, public sf::Transformable {
+public:
+    SdfText(std::shared_ptr<SdfFont> font, const std::string& string = "", unsigned int characterSize = 30);
+
+    void setString(const std::string& string);
+    const std::string& getString() const { return string; }
+
+    void setCharacterSize(unsigned int size);
+    unsigned int getCharacterSize() const { return characterSize; }
+
+    void setFillColor(sf::Color color);
+    sf::Color getFillColor() const { return fillColor; }
+
+    const std::shared_ptr<SdfFont>& getFont() const { return font; }
+
+    // Границы в пикселях текущего размера, как у sf::Text
+    sf::FloatRect getLocalBounds() const;
+    sf::FloatRect getGlobalBounds() const;
+
+    // Рисует ту же закэшированную геометрию со сдвигом и другим цветом — для призраков глитча,
+    // без копий текста и перестройки вершин
+    void drawGhost(sf::RenderTarget& target, sf::Vector2f offset, sf::Color color) const;
+
+    // Для пакетной отрисовки в RenderQueue: вершины уже в координатах сцены, для призраков —
+    // со сдвигом и своим цветом. false — атласа нет, текст рисуется сам как обычный sf::Text
+    bool appendVertices(std::vector<sf::Vertex>& out, sf::Vector2f offset = {},
+        std::optional<sf::Color> color = std::nullopt) const;
+
+    // Экранных пикселей на пиксель BASE_SIZE без учета вида — ключ шейдера сглаживания
+    float getSmoothingScale() const;
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void drawWithColor(sf::RenderTarget& target, sf::RenderStates states, std::optional<sf::Color> color) const;
+    void ensureGeometry() const;
+    float getSizeScale() const;
+
+    std::shared_ptr<SdfFont> font;
+    std::string string;
+    unsigned int characterSize;
+    sf::Color fillColor = sf::Color::White;
+
+    mutable sf::VertexArray vertices{ sf::PrimitiveType::Triangles };
+    mutable sf::FloatRect baseBounds;
+    mutable bool geometryDirty = true;
+
+    // Запасной путь, если атлас не построился
+    mutable std::optional<sf::Text> fallbackText;
+};
@@ -4,11 +4,35 @@
 #include <stdexcept>
 #include <iostream>  // для std::cerr
 #include <cstdlib> 
-SettingsScene::SettingsScene(GameConfig& configRef) : config(configRef) {
-    if (!font.openFromFile("assets/fonts/digital-7 (italic).ttf")) {
-        throw std::runtime_error("Failed to load font");
+#include "ResourceCache.h"
+#include "RenderQueue.h"
+#include "AllocationStats.h"
+#include "Input.h"
+#include <cmath>
+
+namespace {
+    // Доли разрешения сцены, которые предлагаются в настройках
+    const float RENDER_SCALES[] = { 1.0f, 0.85f, 0.75f, 0.67f, 0.5f };
+    const int RENDER_SCALE_COUNT = static_cast<int>(sizeof(RENDER_SCALES) / sizeof(RENDER_SCALES[0]));
+
+    // Координаты холста 1280x720: под размер окна их растягивает вид
+    const unsigned int TEXT_SIZE = 24;
+    const float BASE_X = 100.0f;
+    const float BASE_Y = 100.0f;
+    const float SPACING = 40.0f;
+
+    const char* onOff(bool value) {
+        return value ? "ON" : "OFF";
     }
-    // Убираем updateTexts() из конструктора, так как у нас ещё нет окна
+
+    int wrapIndex(int index, int count) {
+        return (index % count + count) % count;
+    }
+}
+
+SettingsScene::SettingsScene(GameConfig& configRef) : config(configRef) {
+    auto& cache = ResourceCache::instance();
+    font = cache.getSdfFont("font.ui");
     // Найти текущее разрешение в списке
     for (size_t i = 0; i < AVAILABLE_RESOLUTIONS.size(); ++i) {
         if (AVAILABLE_RESOLUTIONS[i].width == config.width &&
@@ -18,67 +42,112 @@ SettingsScene::SettingsScene(GameConfig& configRef) : config(configRef) {
         }
     }
     
-    if (backgroundTexture.loadFromFile("assets/textures/SettingsMenu.png")) {
-        backgroundSprite.emplace(backgroundTexture);
+    // Ближайшая из предложенных долей к сохраненной
+    for (int i = 0; i < RENDER_SCALE_COUNT; ++i) {
+        if (std::abs(RENDER_SCALES[i] - config.renderScale) < std::abs(RENDER_SCALES[renderScaleIndex] - config.renderScale)) {
+            renderScaleIndex = i;
+        }
     }
-    else {
+
+    // Форма настроек читается лучше без дрожания фона; заодно сцена становится статичной
+    glitchRenderer.setBackgroundGlitch(false);
+
+    backgroundTexture = cache.getTexture("tex.settings");
+    if (backgroundTexture->getSize().x == 0) {
         std::cerr << "Failed to load background image for settings.\n";
     }
+
+    buildOptions();
+}
+
+void SettingsScene::buildOptions() {
+    // Настройки идут первыми, за ними "Save & Back"
+    auto resolutionCount = static_cast<int>(AVAILABLE_RESOLUTIONS.size());
+    settings = {
+        { "Resolution",
+            [this] { return AVAILABLE_RESOLUTIONS[currentResolutionIndex].name; },
+            [this, resolutionCount](int step) {
+                currentResolutionIndex = wrapIndex(currentResolutionIndex + step, resolutionCount);
+                config.width = AVAILABLE_RESOLUTIONS[currentResolutionIndex].width;
+                config.height = AVAILABLE_RESOLUTIONS[currentResolutionIndex].height;
+            } },
+        { "Fullscreen",
+            [this] { return std::string(onOff(config.fullscreen)); },
+            [this](int) { config.fullscreen = !config.fullscreen; } },
+        { "VSync",
+            [this] { return std::string(onOff(config.vsync)); },
+            [this](int) { config.vsync = !config.vsync; } },
+        { "Render Scale",
+            [this] { return std::to_string(std::lround(RENDER_SCALES[renderScaleIndex] * 100.f)) + "%"; },
+            // Вправо — большая доля, то есть ближе к началу списка
+            [this](int step) {
+                renderScaleIndex = wrapIndex(renderScaleIndex - step, RENDER_SCALE_COUNT);
+                config.renderScale = RENDER_SCALES[renderScaleIndex];
+            } },
+    };
+
+    options.clear();
+    for (std::size_t i = 0; i <= settings.size(); ++i) {
+        auto text = std::make_unique<SdfText>(font, "", TEXT_SIZE);
+        text->setPosition(sf::Vector2f(BASE_X, BASE_Y + SPACING * static_cast<float>(i)));
+        options.push_back(std::move(text));
+    }
+    options.back()->setString("Save & Back");
+
+    refreshValues();
+    updateColors();
 }
 
 void SettingsScene::update(float dt, sf::RenderWindow& window) {
+    std::size_t allocationsBefore = AllocationStats::getCount();
+
     glitchRenderer.update(dt);
-    updateTexts(window);
-    updatePositions(window);
-    hoveredIndex = -1;
-    sf::Vector2i pixelPos = sf::Mouse::getPosition(window);
-    sf::Vector2f mousePos = window.mapPixelToCoords(pixelPos);
-    for (size_t i = 0; i < menuItems.size(); ++i) {
-        if (menuItems[i]->getGlobalBounds().contains(mousePos)) {
-            hoveredIndex = static_cast<int>(i);
-            break;
-        }
-    }
+
+    frameAllocations += AllocationStats::getCount() - allocationsBefore;
 }
 
-void SettingsScene::render(sf::RenderWindow& window) {
+void SettingsScene::render(sf::RenderTarget& target) {
+    std::size_t allocationsBefore = AllocationStats::getCount();
+
     // Рендерим фон с глич-эффектом
-    glitchRenderer.renderBackground(window, backgroundTexture);
+    glitchRenderer.renderBackground(target, *backgroundTexture);
 
     // Остальные элементы...
+    auto& queue = RenderQueue::instance();
     for (const auto& text : options) {
-        window.draw(*text);
+        queue.submit(*text, RenderQueue::LAYER_TEXT);
     }
+    queue.flush(target);
+
+    // Делим на отрисованные кадры: статичный кадр render() пропускает, быстрый — обходится без update()
+    frameAllocations += AllocationStats::getCount() - allocationsBefore;
+    framesMeasured++;
 }
 
 void SettingsScene::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
+    int backIndex = static_cast<int>(settings.size());
+    const std::optional<Action> action = Input::instance().getAction(event);
+
+    if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+        hoveredIndex = hitGrid.hitTest(window.mapPixelToCoords(moved->position));
+    }
+    else if (event.is<sf::Event::MouseLeft>()) {
+        hoveredIndex = -1;
+    }
+
     // Обработка мыши
-    if (const auto* mouseClick = event.getIf<sf::Event::MouseButtonPressed>()) {
+    if (event.is<sf::Event::MouseButtonPressed>() && action == Action::Select) {
         if (hoveredIndex != -1) {
             selectedIndex = hoveredIndex;
 
-            if (selectedIndex < 3) {
+            if (selectedIndex < backIndex) {
                 // Клик по настройкам - переключаем значение
-                switch (selectedIndex) {
-                case 0:
-                    currentResolutionIndex = (currentResolutionIndex + 1) % static_cast<int>(AVAILABLE_RESOLUTIONS.size());
-                    config.width = AVAILABLE_RESOLUTIONS[currentResolutionIndex].width;
-                    config.height = AVAILABLE_RESOLUTIONS[currentResolutionIndex].height;
-                    break;
-                case 1:
-                    config.fullscreen = !config.fullscreen;
-                    break;
-                case 2:
-                    config.vsync = !config.vsync;
-                    break;
-                }
+                cycleSelected(1);
             }
-            else if (selectedIndex == 3) {
+            else if (selectedIndex == backIndex) {
                 // Клик по "Save & Back"
-                ConfigManager::save(config);
-                finished = true;
+                saveAndExit();
             }
-            updateTexts(window);
         }
     }
 
@@ -87,105 +156,83 @@ void SettingsScene::handleEvent(const sf::Event& event, sf::RenderWindow& window
         selectedIndex = hoveredIndex;
     }
 
-    if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
-        switch (key->scancode) {
-        case sf::Keyboard::Scancode::Down:
-            selectedIndex = (selectedIndex + 1) % 4;
-            updateTexts(window);
-            break;
-        case sf::Keyboard::Scancode::Up:
-            selectedIndex = (selectedIndex + 3) % 4;
-            updateTexts(window);
-            break;
-        case sf::Keyboard::Scancode::Left:
-        case sf::Keyboard::Scancode::Right:
-            switch (selectedIndex) {
-            case 0:
-                if (key->scancode == sf::Keyboard::Scancode::Left) {
-                    currentResolutionIndex = (currentResolutionIndex - 1 + static_cast<int>(AVAILABLE_RESOLUTIONS.size())) % static_cast<int>(AVAILABLE_RESOLUTIONS.size());
-                }
-                else if (key->scancode == sf::Keyboard::Scancode::Right) {
-                    currentResolutionIndex = (currentResolutionIndex + 1) % static_cast<int>(AVAILABLE_RESOLUTIONS.size());
-                }
-                config.width = AVAILABLE_RESOLUTIONS[currentResolutionIndex].width;
-                config.height = AVAILABLE_RESOLUTIONS[currentResolutionIndex].height;
-                break;
-            case 1:
-                config.fullscreen = !config.fullscreen;
-                break;
-            case 2:
-                config.vsync = !config.vsync;
-                break;
-            }
-            updateTexts(window);
-            break;
-        case sf::Keyboard::Scancode::Enter:
-            if (selectedIndex == 3) {
-                ConfigManager::save(config);
-                finished = true;
-            }
-            break;
-        default: break;
-        }
+    updateColors();
+}
+
+void SettingsScene::handleInput(const InputSnapshot& input) {
+    // Клавиатура — по снимку кадра: несколько нажатий одной клавиши за кадр считаются одним
+    int backIndex = static_cast<int>(settings.size());
+    int itemCount = static_cast<int>(options.size());
+
+    if (input.wasPressed(Action::Down)) {
+        selectedIndex = (selectedIndex + 1) % itemCount;
+    }
+    if (input.wasPressed(Action::Up)) {
+        selectedIndex = (selectedIndex + itemCount - 1) % itemCount;
     }
+    if (input.wasPressed(Action::Left)) {
+        cycleSelected(-1);
+    }
+    if (input.wasPressed(Action::Right)) {
+        cycleSelected(1);
+    }
+    if (input.wasPressed(Action::Confirm) && selectedIndex == backIndex) {
+        saveAndExit();
+    }
+    updateColors();
 }
 
-bool SettingsScene::isFinished() const {
-    return finished;
+void SettingsScene::cycleSelected(int step) {
+    if (selectedIndex < 0 || selectedIndex >= static_cast<int>(settings.size())) return;
+
+    settings[selectedIndex].cycle(step);
+    refreshValues();
 }
 
-void SettingsScene::updateTexts(sf::RenderWindow& window) {
-    auto windowSize = window.getSize();
+void SettingsScene::layout(sf::RenderWindow& window) {
+    // Строки стоят на холсте с конструктора; здесь только курсор, который мог оказаться над другой строкой
+    auto pointer = Input::instance().getSnapshot().getPointer(window);
+    hoveredIndex = pointer ? hitGrid.hitTest(*pointer) : -1;
+    updateColors();
+}
 
-    // Базовые размеры для масштабирования
-    float baseWidth = 1280.0f;
-    float baseHeight = 720.0f;
-    float baseTextSize = 24.0f;
-    float baseX = 100.0f;
-    float baseY = 100.0f;
-    float baseSpacing = 40.0f;
+void SettingsScene::rebuildHitGrid() {
+    hitGrid.clear();
+    for (std::size_t i = 0; i < options.size(); ++i) {
+        hitGrid.insert(static_cast<int>(i), options[i]->getGlobalBounds());
+    }
+}
 
-    // Вычисляем масштаб на основе текущего размера окна
-    float scaleX = static_cast<float>(windowSize.x) / baseWidth;
-    float scaleY = static_cast<float>(windowSize.y) / baseHeight;
-    float scale = std::min(scaleX, scaleY);
+void SettingsScene::saveAndExit() {
+    ConfigManager::save(config);
 
-    options.clear();
+    // Назад в меню, которое открыло настройки; SceneManager перечитает конфиг и пересоздаст окно
+    SceneTransition transition = SceneTransition::pop();
+    transition.reloadConfig = true;
+    requestTransition(std::move(transition));
 
-    auto makeOption = [&](const std::string& label, const std::string& value, bool selected) {
-        auto text = std::make_unique<sf::Text>(font);
-        text->setString(label + ": " + value);
-        text->setCharacterSize(static_cast<unsigned int>(baseTextSize * scale));
-        text->setPosition(sf::Vector2f(
-            baseX * scaleX,
-            (baseY + baseSpacing * static_cast<float>(options.size())) * scaleY
-        ));
-        text->setFillColor(selected ? sf::Color::Red : sf::Color::White);
-        return text;
-        };
-
-    std::string resStr = AVAILABLE_RESOLUTIONS[currentResolutionIndex].name;
-    options.push_back(makeOption("Resolution", resStr, selectedIndex == 0));
-    options.push_back(makeOption("Fullscreen", config.fullscreen ? "ON" : "OFF", selectedIndex == 1));
-    options.push_back(makeOption("VSync", config.vsync ? "ON" : "OFF", selectedIndex == 2));
-
-    auto back = std::make_unique<sf::Text>(font);
-    back->setString("Save & Back");
-    back->setCharacterSize(static_cast<unsigned int>(baseTextSize * scale));
-    back->setPosition(sf::Vector2f(
-        baseX * scaleX,
-        (baseY + baseSpacing * static_cast<float>(options.size())) * scaleY
-    ));
-    back->setFillColor(selectedIndex == 3 ? sf::Color::Red : sf::Color::White);
-    options.push_back(std::move(back));
-    // Обновляем menuItems для работы с мышью
-    menuItems.clear();
-    for (auto& option : options) {
-        menuItems.push_back(option.get());
+    if (AllocationStats::isEnabled() && framesMeasured > 0) {
+        std::cout << "SettingsScene: " << frameAllocations << " allocations in " << framesMeasured
+            << " frames (" << static_cast<double>(frameAllocations) / framesMeasured << " per frame)" << std::endl;
     }
 }
-void SettingsScene::updatePositions(sf::RenderWindow& window) {
-    // Обновляем цвета на основе наведения мыши
+
+void SettingsScene::refreshValues() {
+    // Строка пересобирается только у настройки, значение которой действительно изменилось
+    for (std::size_t i = 0; i < settings.size(); ++i) {
+        std::string value = settings[i].value();
+        if (value == settings[i].shownValue) continue;
+
+        settings[i].shownValue = std::move(value);
+        options[i]->setString(settings[i].label + ": " + settings[i].shownValue);
+    }
+
+    // Ширина строк могла измениться
+    rebuildHitGrid();
+}
+
+void SettingsScene::updateColors() {
+    // setFillColor сам пропускает неизменившийся цвет, так что вершины не трогаются
     for (size_t i = 0; i < options.size(); ++i) {
         if (static_cast<int>(i) == hoveredIndex) {
             options[i]->setFillColor(sf::Color::Red);  // Наведение мышью
@@ -197,4 +244,4 @@ void SettingsScene::updatePositions(sf::RenderWindow& window) {
             options[i]->setFillColor(sf::Color::White);  // Обычный цвет
         }
     }
-}
\ No newline at end of file
+}
@@ -4,31 +4,57 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <string>
 #include "GlitchRenderer.h"
+#include "SdfText.h"
+#include "HitGrid.h"
 class SettingsScene : public Scene {
 public:
     SettingsScene(GameConfig& config);
     void update(float dt, sf::RenderWindow& window) override;
-    void render(sf::RenderWindow& window) override;
+    void render(sf::RenderTarget& target) override;
+    void layout(sf::RenderWindow& window) override;
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
-    bool isFinished() const override;
+    void handleInput(const InputSnapshot& input) override;
+
+    // Без дрожания фона экран меняется только от ввода
+    bool isStatic() const override { return !glitchRenderer.isAnimating(); }
 
 private:
+    // Описание строки настроек: подпись, текущее значение и переключение (+1 вправо, -1 влево)
+    struct SettingOption {
+        std::string label;
+        std::function<std::string()> value;
+        std::function<void(int step)> cycle;
+        std::string shownValue;
+    };
+
     GlitchRenderer glitchRenderer;
     int currentResolutionIndex = 0;
+    int renderScaleIndex = 0;
     GameConfig& config;
-    sf::Font font;
-    std::vector<std::unique_ptr<sf::Text>> options;
+    std::shared_ptr<SdfFont> font;
+
+    // Строки создаются один раз; options[i] — текст settings[i], последним идет "Save & Back"
+    std::vector<SettingOption> settings;
+    std::vector<std::unique_ptr<SdfText>> options;
     int selectedIndex = 0;
-    bool finished = false;
 
-    void updateTexts(sf::RenderWindow& window);
-    std::vector<sf::Text*> menuItems;
+    void buildOptions();
+    void refreshValues();
+    void updateColors();
+    void cycleSelected(int step);
+    void saveAndExit();
+    void rebuildHitGrid();
+
+    // Наведение по закэшированным границам строк, только на MouseMoved
+    HitGrid hitGrid;
     int hoveredIndex = -1;
-    void updatePositions(sf::RenderWindow& window);
 
-    sf::Texture backgroundTexture;
-    std::optional<sf::Sprite> backgroundSprite;
-    
-    
-};
\ No newline at end of file
+    // Выделения главного потока за отрисованные кадры сцены — выводятся при выходе
+    std::size_t frameAllocations = 0;
+    std::size_t framesMeasured = 0;
+
+    std::shared_ptr<sf::Texture> backgroundTexture;
+};
@@ -1,35 +1,32 @@
 ﻿#include "SplashScene.h"
 #include <iostream>
-#include <random>
+#include "Rng.h"
 #include <SFML/Graphics.hpp>
+#include "ResourceCache.h"
+#include "AssetLoader.h"
+#include "RenderQueue.h"
+#include "VirtualCanvas.h"
+
+namespace {
+    const sf::Vector2f BAR_SIZE(400.f, 6.f);
+}
 
 SplashScene::SplashScene()
 {
-    std::vector<std::string> fontPaths = {
-        "assets/fonts/digital-7 (italic).ttf",
-        "arial.ttf",
-        "../assets/fonts/arial.ttf",
-        "C:\\Windows\\Fonts\\arial.ttf",
-        "C:\\Windows\\Fonts\\calibri.ttf"
-    };
-
-    for (const auto& path : fontPaths) {
-        if (font.openFromFile(path)) {  // SFML 3.x - openFromFile
-            fontLoaded = true;
-            std::cout << "Font loaded from: " << path << std::endl;
-            break;
-        }
-    }
+    auto& cache = ResourceCache::instance();
+    font = cache.getFont("font.ui");
 
-    if (!fontLoaded) {
-        std::cerr << "Warning: Could not load any font file. Text may not display correctly." << std::endl;
-    }
-
-    titleText = std::make_unique<sf::Text>(font, "PRESS ANY KEY TO CONTINUE", 24);
+    titleText = std::make_unique<sf::Text>(*font, "LOADING 0%", 24);
     titleText->setFillColor(sf::Color(139, 0, 0));
 
-    if (backgroundTexture.loadFromFile("assets/textures/splash_background.jpg")) {
-        backgroundSprite = std::make_unique<sf::Sprite>(backgroundTexture);
+    progressBack.setFillColor(sf::Color(40, 0, 0, 180));
+    progressBack.setOutlineColor(sf::Color(139, 0, 0));
+    progressBack.setOutlineThickness(1.f);
+    progressFill.setFillColor(sf::Color(139, 0, 0));
+
+    backgroundTexture = cache.getTexture("tex.splash");
+    if (backgroundTexture->getSize().x > 0) {
+        backgroundSprite = std::make_unique<sf::Sprite>(*backgroundTexture);
     }
     else {
         std::cerr << "Failed to load splash background image." << std::endl;
@@ -37,26 +34,51 @@ SplashScene::SplashScene()
 }
 
 void SplashScene::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
+    // Пока ассеты не загружены, меню открывать нельзя — иначе оно полезет на диск само
+    if (!loadingComplete) return;
+
     if (event.is<sf::Event::KeyPressed>() || event.is<sf::Event::MouseButtonPressed>()) {
-        finished = true;
+        requestTransition(SceneTransition::replace(SceneId::MainMenu));
     }
 }
 
 void SplashScene::update(float dt, sf::RenderWindow& window) {
-    // Обновляем позиции для корректного масштабирования
-    updatePositions(window);
+    updateProgress();
+}
+
+void SplashScene::updateProgress() {
+    if (loadingComplete || !titleText) return;
+
+    auto& loader = AssetLoader::instance();
+    int percent = static_cast<int>(loader.getProgress() * 100.f);
+
+    // Текст перестраиваем только когда процент реально изменился
+    if (loader.isIdle()) {
+        loadingComplete = true;
+        titleText->setString("PRESS ANY KEY TO CONTINUE");
+        centerTitle();
+        std::cout << "SplashScene: all assets loaded" << std::endl;
+    }
+    else if (percent != shownPercent) {
+        shownPercent = percent;
+        titleText->setString("LOADING " + std::to_string(percent) + "%");
+        centerTitle();
+        progressFill.setSize(sf::Vector2f(BAR_SIZE.x * loader.getProgress(), BAR_SIZE.y));
+    }
 }
 
-void SplashScene::render(sf::RenderWindow& window) {
-    auto windowSize = window.getSize();
+void SplashScene::render(sf::RenderTarget& target) {
+    // Видимая область вида: холст 1280x720, расширенный по длинной стороне окна
+    sf::FloatRect area = VirtualCanvas::getVisibleArea(target);
+    auto& queue = RenderQueue::instance();
 
     // Рендеринг фона с корректным масштабированием
     if (backgroundSprite) {
-        auto textureSize = backgroundTexture.getSize();
+        auto textureSize = backgroundTexture->getSize();
 
-        // Вычисляем масштаб для заполнения всего окна с сохранением пропорций
-        float scaleX = static_cast<float>(windowSize.x) / static_cast<float>(textureSize.x);
-        float scaleY = static_cast<float>(windowSize.y) / static_cast<float>(textureSize.y);
+        // Вычисляем масштаб для заполнения всей видимой области с сохранением пропорций
+        float scaleX = area.size.x / static_cast<float>(textureSize.x);
+        float scaleY = area.size.y / static_cast<float>(textureSize.y);
         float scale = std::max(scaleX, scaleY);
 
         backgroundSprite->setScale(sf::Vector2f(scale, scale));
@@ -64,78 +86,69 @@ void SplashScene::render(sf::RenderWindow& window) {
         // Центрируем спрайт
         float spriteWidth = static_cast<float>(textureSize.x) * scale;
         float spriteHeight = static_cast<float>(textureSize.y) * scale;
-        float offsetX = (static_cast<float>(windowSize.x) - spriteWidth) / 2.f;
-        float offsetY = (static_cast<float>(windowSize.y) - spriteHeight) / 2.f;
+        float offsetX = area.position.x + (area.size.x - spriteWidth) / 2.f;
+        float offsetY = area.position.y + (area.size.y - spriteHeight) / 2.f;
 
         backgroundSprite->setPosition(sf::Vector2f(offsetX, offsetY));
-        window.draw(*backgroundSprite);
+        queue.submit(*backgroundSprite, RenderQueue::LAYER_BACKGROUND);
     }
 
     // Рендеринг текста с корректным позиционированием
     if (titleText) {
-        window.draw(*titleText);
+        queue.submit(*titleText, RenderQueue::LAYER_TEXT);
+    }
+
+    // Подложка и заполнение полосы загрузки — один пакет без текстуры
+    if (!loadingComplete) {
+        queue.submit(progressBack, RenderQueue::LAYER_WIDGETS, 0);
+        queue.submit(progressFill, RenderQueue::LAYER_WIDGETS, 1);
     }
+    queue.flush(target);
 
     // Глич-эффект линий
     sf::VertexArray lines(sf::PrimitiveType::Lines);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> y_dist(0, windowSize.y);
-    std::uniform_int_distribution<int> brightness(100, 255);
+    auto& rng = Rng::instance().stream(RngStreamId::Splash);
 
     for (int i = 0; i < 15; ++i) {
-        int y = y_dist(gen);
-        sf::Color glitchColor(brightness(gen), 0, 0);
+        float y = area.position.y + static_cast<float>(rng.range(0, static_cast<int>(area.size.y)));
+        sf::Color glitchColor(static_cast<std::uint8_t>(rng.range(100, 255)), 0, 0);
 
         sf::Vertex v1;
-        v1.position = sf::Vector2f(0.f, static_cast<float>(y));
+        v1.position = sf::Vector2f(area.position.x, y);
         v1.color = glitchColor;
 
         sf::Vertex v2;
-        v2.position = sf::Vector2f(static_cast<float>(windowSize.x), static_cast<float>(y));
+        v2.position = sf::Vector2f(area.position.x + area.size.x, y);
         v2.color = glitchColor;
 
         lines.append(v1);
         lines.append(v2);
     }
 
-    window.draw(lines);
+    target.draw(lines);
 }
 
-bool SplashScene::isFinished() const {
-    return finished;
-}
-
-void SplashScene::updatePositions(sf::RenderWindow& window) {
+void SplashScene::layout(sf::RenderWindow& window) {
     if (!titleText) return;
 
-    auto windowSize = window.getSize();
-
-    // Базовые размеры для масштабирования
-    float baseWidth = 1280.0f;
-    float baseHeight = 720.0f;
-    float baseTextSize = 24.0f;
+    // Координаты холста 1280x720; текст растеризуется под масштаб окна, чтобы не мылился
+    VirtualCanvas::fitText(*titleText, 24.f, VirtualCanvas::getPixelScale(window.getSize()));
+    centerTitle();
 
-    // Вычисляем масштаб на основе текущего размера окна
-    float scaleX = static_cast<float>(windowSize.x) / baseWidth;
-    float scaleY = static_cast<float>(windowSize.y) / baseHeight;
-    float scale = std::min(scaleX, scaleY); // Используем минимальный масштаб для сохранения пропорций
-
-    // Применяем масштаб к размеру текста
-    titleText->setCharacterSize(static_cast<unsigned int>(baseTextSize * scale));
+    // Полоса загрузки под текстом
+    sf::Vector2f barPos((VirtualCanvas::WIDTH - BAR_SIZE.x) / 2.f, VirtualCanvas::HEIGHT * 0.9f);
+    progressBack.setSize(BAR_SIZE);
+    progressBack.setPosition(barPos);
+    progressFill.setPosition(barPos);
+    progressFill.setSize(sf::Vector2f(BAR_SIZE.x * AssetLoader::instance().getProgress(), BAR_SIZE.y));
+}
 
-    // Центрируем текст по горизонтали и размещаем в нижней части экрана
+void SplashScene::centerTitle() {
+    // Центрируем текст по горизонтали и размещаем в нижней части экрана (85% от высоты)
     auto bounds = titleText->getLocalBounds();
     titleText->setOrigin(sf::Vector2f(
         bounds.position.x + bounds.size.x / 2.f,
         bounds.position.y + bounds.size.y / 2.f
     ));
-
-    // Позиционируем текст в нижней части экрана (85% от высоты)
-    titleText->setPosition(sf::Vector2f(
-        static_cast<float>(windowSize.x) / 2.f,
-        static_cast<float>(windowSize.y) * 0.85f
-    ));
+    titleText->setPosition(sf::Vector2f(VirtualCanvas::WIDTH / 2.f, VirtualCanvas::HEIGHT * 0.85f));
 }
-
-
@@ -10,20 +10,24 @@ public:
 
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
     void update(float dt, sf::RenderWindow& window) override;
-    void render(sf::RenderWindow& window) override;
-    bool isFinished() const override;
+    void render(sf::RenderTarget& target) override;
+    void layout(sf::RenderWindow& window) override;
 
 private:
-    bool finished = false;
-    bool fontLoaded = false;
-
-    sf::Font font;
+    std::shared_ptr<sf::Font> font;
     std::unique_ptr<sf::Text> titleText;
 
-    sf::Texture backgroundTexture;
+    std::shared_ptr<sf::Texture> backgroundTexture;
     std::unique_ptr<sf::Sprite> backgroundSprite;
 
-    void updatePositions(sf::RenderWindow& window);
+    // Прогресс фоновой загрузки ассетов
+    sf::RectangleShape progressBack;
+    sf::RectangleShape progressFill;
+    int shownPercent = -1;
+    bool loadingComplete = false;
+
+    void updateProgress();
+    void centerTitle();
 };
 
 
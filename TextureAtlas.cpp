@@ -0,0 +1,153 @@
+﻿#include "TextureAtlas.h"
+#include <algorithm>
+#include <iostream>
+
+TextureAtlas::TextureAtlas(sf::Vector2u initialSize, unsigned int padding)
+    : initialSize(initialSize), image(initialSize, sf::Color::Transparent), padding(padding) {
+}
+
+std::optional<sf::Vector2u> TextureAtlas::allocate(sf::Vector2u size) {
+    unsigned int width = size.x + padding;
+    unsigned int height = size.y + padding;
+    auto atlasSize = image.getSize();
+
+    // Ищем самую низкую подходящую полку, чтобы меньше терять по высоте
+    Shelf* best = nullptr;
+    for (auto& shelf : shelves) {
+        if (shelf.height >= height && shelf.cursorX + width <= atlasSize.x) {
+            if (!best || shelf.height < best->height) {
+                best = &shelf;
+            }
+        }
+    }
+
+    if (!best) {
+        if (nextShelfY + height > atlasSize.y || width > atlasSize.x) {
+            return std::nullopt;
+        }
+        shelves.push_back({ nextShelfY, height, 0 });
+        nextShelfY += height;
+        best = &shelves.back();
+    }
+
+    sf::Vector2u position(best->cursorX, best->y);
+    best->cursorX += width;
+    return position;
+}
+
+bool TextureAtlas::grow() {
+    auto oldSize = image.getSize();
+    unsigned int maxSize = sf::Texture::getMaximumSize();
+
+    // Сначала растем по высоте — ширина полок при этом остается валидной
+    sf::Vector2u newSize = oldSize;
+    if (oldSize.y < maxSize) {
+        newSize.y = std::min(oldSize.y * 2, maxSize);
+    }
+    else if (oldSize.x < maxSize) {
+        newSize.x = std::min(oldSize.x * 2, maxSize);
+    }
+    else {
+        return false;
+    }
+
+    sf::Image grown(newSize, sf::Color::Transparent);
+    if (!grown.copy(image, { 0, 0 })) {
+        return false;
+    }
+    image = std::move(grown);
+    dirty = true;
+    return true;
+}
+
+std::optional<sf::IntRect> TextureAtlas::insert(const sf::Image& source) {
+    return insertRegion(source, sf::IntRect({ 0, 0 }, sf::Vector2i(source.getSize())));
+}
+
+std::optional<sf::IntRect> TextureAtlas::insertRegion(const sf::Image& source, const sf::IntRect& sourceRect) {
+    sf::Vector2u size(sourceRect.size);
+    if (size.x == 0 || size.y == 0) return std::nullopt;
+
+    auto position = allocate(size);
+    while (!position && grow()) {
+        position = allocate(size);
+    }
+
+    if (!position) {
+        std::cerr << "TextureAtlas: no room for " << size.x << "x" << size.y << " image" << std::endl;
+        return std::nullopt;
+    }
+
+    if (!image.copy(source, *position, sourceRect)) {
+        return std::nullopt;
+    }
+
+    usedBytes += static_cast<std::size_t>(size.x) * size.y * 4;
+    dirty = true;
+    return sf::IntRect(sf::Vector2i(*position), sf::Vector2i(size));
+}
+
+bool TextureAtlas::upload() {
+    if (!dirty) return true;
+
+    // Обрезаем пустой хвост снизу, чтобы не держать в GPU лишние строки
+    auto size = image.getSize();
+    unsigned int usedHeight = std::max(1u, std::min(nextShelfY, size.y));
+    if (!texture.loadFromImage(image, false, sf::IntRect({ 0, 0 }, { static_cast<int>(size.x), static_cast<int>(usedHeight) }))) {
+        std::cerr << "TextureAtlas: upload failed" << std::endl;
+        return false;
+    }
+    if (mipmapped && !texture.generateMipmap()) {
+        // Без мип-уровней картинка рисуется, только мерцает при сильном уменьшении
+        std::cerr << "TextureAtlas: mipmap generation failed" << std::endl;
+    }
+
+    dirty = false;
+    return true;
+}
+
+std::optional<std::vector<sf::IntRect>> TextureAtlas::compact(const std::vector<sf::IntRect>& keep) {
+    // Старый образ остается источником пикселей, новый начинается с исходного размера
+    sf::Image old = std::move(image);
+    std::vector<Shelf> oldShelves = std::move(shelves);
+    unsigned int oldNextShelfY = nextShelfY;
+    std::size_t oldUsedBytes = usedBytes;
+    bool oldDirty = dirty;
+    clear();
+
+    std::vector<sf::IntRect> result;
+    result.reserve(keep.size());
+    for (const auto& rect : keep) {
+        auto placed = insertRegion(old, rect);
+        if (!placed) {
+            // Частичная перепаковка оставила бы части без картинки: возвращаем прежнюю раскладку
+            image = std::move(old);
+            shelves = std::move(oldShelves);
+            nextShelfY = oldNextShelfY;
+            usedBytes = oldUsedBytes;
+            dirty = oldDirty;
+            return std::nullopt;
+        }
+        result.push_back(*placed);
+    }
+    return result;
+}
+
+void TextureAtlas::setMipmapped(bool enabled) {
+    mipmapped = enabled;
+    texture.setSmooth(enabled);
+    dirty = true;
+}
+
+void TextureAtlas::clear() {
+    image = sf::Image(initialSize, sf::Color::Transparent);
+    shelves.clear();
+    nextShelfY = 0;
+    usedBytes = 0;
+    dirty = true;
+}
+
+std::size_t TextureAtlas::getTextureBytes() const {
+    auto size = texture.getSize();
+    return static_cast<std::size_t>(size.x) * size.y * 4;
+}
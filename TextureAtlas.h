@@ -0,0 +1,55 @@
+﻿// TextureAtlas.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <optional>
+#include <vector>
+#include <cstddef>
+
+// Простой атлас с упаковкой по полкам (shelf packing).
+// Картинки копируются в CPU-образ, upload() отправляет его в одну sf::Texture.
+class TextureAtlas {
+public:
+    explicit TextureAtlas(sf::Vector2u initialSize = { 1024, 1024 }, unsigned int padding = 1);
+
+    // Возвращает прямоугольник внутри атласа или nullopt, если места нет даже после роста
+    std::optional<sf::IntRect> insert(const sf::Image& image);
+
+    // Перепаковывает атлас только из перечисленных прямоугольников, место остальных освобождается.
+    // Возвращает новые прямоугольники в том же порядке. Если хоть один не поместился, атлас
+    // остается прежним (старые прямоугольники действительны) и возвращается nullopt
+    std::optional<std::vector<sf::IntRect>> compact(const std::vector<sf::IntRect>& keep);
+
+    bool upload();
+    void clear();
+
+    // Для картинок, которые рисуются заметно меньше своего размера: сглаживание и мип-уровни,
+    // которые перестраиваются при каждой выгрузке
+    void setMipmapped(bool enabled);
+
+    const sf::Texture& getTexture() const { return texture; }
+    sf::Vector2u getSize() const { return image.getSize(); }
+    std::size_t getTextureBytes() const;
+    std::size_t getUsedBytes() const { return usedBytes; }
+    bool isDirty() const { return dirty; }
+
+private:
+    struct Shelf {
+        unsigned int y = 0;
+        unsigned int height = 0;
+        unsigned int cursorX = 0;
+    };
+
+    std::optional<sf::Vector2u> allocate(sf::Vector2u size);
+    std::optional<sf::IntRect> insertRegion(const sf::Image& source, const sf::IntRect& sourceRect);
+    bool grow();
+
+    sf::Vector2u initialSize;
+    sf::Image image;
+    sf::Texture texture;
+    std::vector<Shelf> shelves;
+    unsigned int nextShelfY = 0;
+    unsigned int padding;
+    std::size_t usedBytes = 0;
+    bool dirty = false;
+    bool mipmapped = false;
+};
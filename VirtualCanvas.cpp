@@ -0,0 +1,29 @@
+﻿#include "VirtualCanvas.h"
+#include <algorithm>
+#include <cmath>
+
+float VirtualCanvas::getPixelScale(sf::Vector2u windowSize) {
+    if (windowSize.x == 0 || windowSize.y == 0) return 1.f;
+    return std::min(static_cast<float>(windowSize.x) / WIDTH, static_cast<float>(windowSize.y) / HEIGHT);
+}
+
+sf::View VirtualCanvas::makeView(sf::Vector2u windowSize) {
+    float scale = getPixelScale(windowSize);
+    sf::Vector2f visible(static_cast<float>(windowSize.x) / scale, static_cast<float>(windowSize.y) / scale);
+    if (windowSize.x == 0 || windowSize.y == 0) {
+        visible = sf::Vector2f(WIDTH, HEIGHT);
+    }
+    return sf::View(sf::Vector2f(WIDTH / 2.f, HEIGHT / 2.f), visible);
+}
+
+sf::FloatRect VirtualCanvas::getVisibleArea(const sf::RenderTarget& target) {
+    const sf::View& view = target.getView();
+    return sf::FloatRect(view.getCenter() - view.getSize() / 2.f, view.getSize());
+}
+
+void VirtualCanvas::fitText(sf::Text& text, float size, float pixelScale) {
+    unsigned int pixelSize = std::max(1u, static_cast<unsigned int>(std::lround(size * pixelScale)));
+    float scale = size / static_cast<float>(pixelSize);
+    text.setCharacterSize(pixelSize);
+    text.setScale(sf::Vector2f(scale, scale));
+}
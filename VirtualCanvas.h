@@ -0,0 +1,24 @@
+﻿// VirtualCanvas.h
+#pragma once
+#include <SFML/Graphics.hpp>
+
+// Виртуальный холст 1280x720: сцены раскладывают на нем интерфейс один раз, а окно
+// показывает его через sf::View. Масштаб равномерный, холст по центру; если пропорции окна
+// другие, видимая область шире (или выше) холста, и фон заполняет ее целиком
+class VirtualCanvas {
+public:
+    static constexpr float WIDTH = 1280.f;
+    static constexpr float HEIGHT = 720.f;
+
+    // Пикселей окна на единицу холста
+    static float getPixelScale(sf::Vector2u windowSize);
+
+    static sf::View makeView(sf::Vector2u windowSize);
+
+    // Видимая часть в координатах текущего вида цели (может выходить за 0..WIDTH и 0..HEIGHT)
+    static sf::FloatRect getVisibleArea(const sf::RenderTarget& target);
+
+    // sf::Text растеризуется в пикселях окна: глифы берутся размера size * pixelScale,
+    // а сам текст уменьшается обратно, чтобы не размываться при растяжении вида
+    static void fitText(sf::Text& text, float size, float pixelScale);
+};
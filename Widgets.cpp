@@ -0,0 +1,314 @@
+﻿#include "Widgets.h"
+#include "ResourceCache.h"
+#include "Config.h"
+#include "VirtualCanvas.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+    const sf::Color TEXT_COLOR(139, 0, 0);
+    const sf::Color VALUE_COLOR(200, 200, 200);
+
+    const sf::Color BUTTON_FILL(50, 50, 50, 180);
+    const sf::Color BUTTON_OUTLINE(139, 0, 0);
+    const sf::Color BUTTON_HOVER_FILL(80, 80, 80, 200);
+    const sf::Color BUTTON_HOVER_OUTLINE(200, 0, 0);
+    const float BUTTON_OUTLINE_THICKNESS = 2.f;
+
+    const sf::Color CARD_OUTLINE = sf::Color::Green;
+    const sf::Color CARD_HOVER_OUTLINE = sf::Color::Yellow;
+
+    const unsigned int LINE_TEXT_SIZE = 24;
+
+    // Уменьшенная копия картинки в размер ячейки атласа; маленькие копируются как есть
+    sf::Image fitToCell(sf::Texture& texture, sf::Vector2u cell) {
+        auto size = texture.getSize();
+        if (size.x <= cell.x && size.y <= cell.y) {
+            return texture.copyToImage();
+        }
+
+        float scale = std::min(static_cast<float>(cell.x) / size.x, static_cast<float>(cell.y) / size.y);
+        sf::Vector2u target(
+            std::max(1u, static_cast<unsigned int>(std::lround(size.x * scale))),
+            std::max(1u, static_cast<unsigned int>(std::lround(size.y * scale))));
+
+        sf::RenderTexture canvas;
+        if (!canvas.resize(target)) {
+            std::cerr << "CardAtlas: failed to create downscale target, copying full image" << std::endl;
+            return texture.copyToImage();
+        }
+
+        // Сглаживание только на время уменьшения: текстура общая, ее держит ResourceCache
+        bool wasSmooth = texture.isSmooth();
+        texture.setSmooth(true);
+
+        sf::Sprite sprite(texture);
+        sprite.setScale({ static_cast<float>(target.x) / size.x, static_cast<float>(target.y) / size.y });
+        canvas.clear(sf::Color::Transparent);
+        canvas.draw(sprite, sf::RenderStates(sf::BlendNone));
+        canvas.display();
+
+        texture.setSmooth(wasSmooth);
+        return canvas.getTexture().copyToImage();
+    }
+}
+
+// CardAtlas
+
+CardAtlas& CardAtlas::instance() {
+    static CardAtlas cardAtlas;
+    return cardAtlas;
+}
+
+sf::Vector2u CardAtlas::getCellSize() {
+    static const sf::Vector2u cell = [] {
+        float scale = 1.f;
+        for (const auto& resolution : AVAILABLE_RESOLUTIONS) {
+            scale = std::max(scale, VirtualCanvas::getPixelScale({ resolution.width, resolution.height }));
+        }
+        return sf::Vector2u(static_cast<unsigned int>(std::ceil(MAX_CARD_WIDTH * scale)),
+            static_cast<unsigned int>(std::ceil(MAX_CARD_HEIGHT * scale)));
+    }();
+    return cell;
+}
+
+std::optional<sf::IntRect> CardAtlas::getRect(const std::string& textureId) {
+    auto found = rects.find(textureId);
+    if (found != rects.end()) {
+        return found->second;
+    }
+
+    std::optional<sf::IntRect> rect;
+    auto texture = ResourceCache::instance().getTexture(textureId);
+    if (texture->getSize().x > 0) {
+        rect = atlas.insert(fitToCell(*texture, getCellSize()));
+        if (rect) {
+            atlas.upload();
+        }
+        else {
+            std::cerr << "CardAtlas: no room for " << textureId << std::endl;
+        }
+    }
+
+    rects.emplace(textureId, rect);
+    return rect;
+}
+
+// UiButton
+
+UiButton::UiButton(const std::shared_ptr<SdfFont>& font, const std::string& text,
+    sf::Vector2f position, sf::Vector2f size, unsigned int textSize)
+    : label(font, text, textSize) {
+    shape.setSize(size);
+    shape.setPosition(position);
+    shape.setFillColor(BUTTON_FILL);
+    shape.setOutlineColor(BUTTON_OUTLINE);
+    shape.setOutlineThickness(BUTTON_OUTLINE_THICKNESS);
+    label.setFillColor(TEXT_COLOR);
+    centerLabel();
+}
+
+void UiButton::setPosition(sf::Vector2f position) {
+    shape.setPosition(position);
+    centerLabel();
+}
+
+void UiButton::setSize(sf::Vector2f size) {
+    shape.setSize(size);
+    centerLabel();
+}
+
+void UiButton::setLabel(const std::string& text) {
+    label.setString(text);
+    centerLabel();
+}
+
+void UiButton::centerLabel() {
+    sf::Vector2f position = shape.getPosition();
+    sf::Vector2f size = shape.getSize();
+    sf::FloatRect bounds = label.getLocalBounds();
+    label.setPosition({
+        position.x + (size.x - bounds.size.x) / 2.f - bounds.position.x,
+        position.y + (size.y - bounds.size.y) / 2.f - bounds.position.y
+        });
+}
+
+bool UiButton::contains(sf::Vector2f point) const {
+    return shape.getGlobalBounds().contains(point);
+}
+
+void UiButton::setHovered(bool value) {
+    if (hovered == value) return;
+
+    hovered = value;
+    shape.setFillColor(hovered ? BUTTON_HOVER_FILL : BUTTON_FILL);
+    shape.setOutlineColor(hovered ? BUTTON_HOVER_OUTLINE : BUTTON_OUTLINE);
+}
+
+bool UiButton::click(sf::Vector2f point) {
+    if (!contains(point)) return false;
+
+    if (onClick) onClick();
+    return true;
+}
+
+void UiButton::render(RenderQueue& queue) const {
+    queue.submit(shape, RenderQueue::LAYER_WIDGETS);
+    queue.submit(label, RenderQueue::LAYER_TEXT);
+}
+
+// UiCard
+
+UiCard::UiCard(const std::shared_ptr<SdfFont>& font, const std::string& text, const std::string& imageId)
+    : label(text), labelText(font, text, 32) {
+    auto& cardAtlas = CardAtlas::instance();
+    if (auto rect = cardAtlas.getRect(imageId)) {
+        image.emplace(cardAtlas.getTexture(), *rect);
+    }
+    else {
+        std::cerr << "Failed to load card image for " << text << ": " << imageId << std::endl;
+    }
+
+    border.setFillColor(sf::Color::Transparent);
+    border.setOutlineThickness(1.f);
+    border.setOutlineColor(CARD_OUTLINE);
+    labelText.setFillColor(TEXT_COLOR);
+}
+
+void UiCard::setPosition(sf::Vector2f position) {
+    if (image) image->setPosition(position);
+    border.setPosition(position);
+    labelText.setPosition({ position.x + 10.f, position.y + border.getSize().y + 10.f });
+}
+
+void UiCard::setSize(sf::Vector2f size) {
+    border.setSize(size);
+    if (image) {
+        sf::Vector2i cell = image->getTextureRect().size;
+        image->setScale({ size.x / cell.x, size.y / cell.y });
+    }
+    setPosition(border.getPosition());
+}
+
+void UiCard::setLabelSize(unsigned int size) {
+    labelText.setCharacterSize(size);
+}
+
+sf::FloatRect UiCard::getBounds() const {
+    return border.getGlobalBounds();
+}
+
+bool UiCard::contains(sf::Vector2f point) const {
+    return getBounds().contains(point);
+}
+
+void UiCard::setHovered(bool hovered) {
+    border.setOutlineColor(hovered ? CARD_HOVER_OUTLINE : CARD_OUTLINE);
+}
+
+void UiCard::render(RenderQueue& queue) const {
+    // Картинки всех карточек — одна текстура атласа; рамки поверх картинок
+    if (image) queue.submit(*image, RenderQueue::LAYER_WIDGETS, 0);
+    queue.submit(border, RenderQueue::LAYER_WIDGETS, 1);
+    queue.submit(labelText, RenderQueue::LAYER_TEXT);
+}
+
+// UiSpinner
+
+UiSpinner::UiSpinner(const std::shared_ptr<SdfFont>& font, const std::string& name, std::vector<std::string> values)
+    : options(std::move(values)),
+    nameText(font, name, LINE_TEXT_SIZE),
+    valueText(font, "", LINE_TEXT_SIZE),
+    prevButton(font, "<", {}, { 35.f, 30.f }),
+    nextButton(font, ">", {}, { 35.f, 30.f }) {
+    nameText.setFillColor(TEXT_COLOR);
+    valueText.setFillColor(VALUE_COLOR);
+    if (!options.empty()) valueText.setString(options[0]);
+
+    prevButton.setOnClick([this]() { step(-1); });
+    nextButton.setOnClick([this]() { step(1); });
+}
+
+void UiSpinner::setPosition(sf::Vector2f position) {
+    nameText.setPosition(position);
+    valueText.setPosition({ position.x + 250.f, position.y });
+    prevButton.setPosition({ position.x + 400.f, position.y });
+    nextButton.setPosition({ position.x + 440.f, position.y });
+}
+
+void UiSpinner::setValue(int index) {
+    if (index < 0 || index >= static_cast<int>(options.size())) return;
+
+    currentIndex = index;
+    valueText.setString(options[currentIndex]);
+    if (onValueChanged) onValueChanged(currentIndex);
+}
+
+void UiSpinner::step(int delta) {
+    int count = static_cast<int>(options.size());
+    if (count == 0) return;
+
+    setValue(((currentIndex + delta) % count + count) % count);
+}
+
+void UiSpinner::updateHover(sf::Vector2f mousePos) {
+    prevButton.setHovered(prevButton.contains(mousePos));
+    nextButton.setHovered(nextButton.contains(mousePos));
+}
+
+bool UiSpinner::handleClick(sf::Vector2f mousePos) {
+    return prevButton.click(mousePos) || nextButton.click(mousePos);
+}
+
+void UiSpinner::render(RenderQueue& queue) const {
+    queue.submit(nameText, RenderQueue::LAYER_TEXT);
+    queue.submit(valueText, RenderQueue::LAYER_TEXT);
+    prevButton.render(queue);
+    nextButton.render(queue);
+}
+
+// UiStepper
+
+UiStepper::UiStepper(const std::shared_ptr<SdfFont>& font, const std::string& name)
+    : nameText(font, name, LINE_TEXT_SIZE),
+    valueText(font, "0", LINE_TEXT_SIZE),
+    minusButton(font, "-"),
+    plusButton(font, "+") {
+    nameText.setFillColor(TEXT_COLOR);
+    valueText.setFillColor(TEXT_COLOR);
+
+    minusButton.setOnClick([this]() { if (allowed(-1) && onStep) onStep(-1); });
+    plusButton.setOnClick([this]() { if (allowed(1) && onStep) onStep(1); });
+}
+
+void UiStepper::setPosition(sf::Vector2f position) {
+    nameText.setPosition(position);
+    valueText.setPosition({ position.x + 300.f, position.y });
+    minusButton.setPosition({ position.x + 350.f, position.y - 3.f });
+    plusButton.setPosition({ position.x + 390.f, position.y - 3.f });
+}
+
+void UiStepper::setValue(int newValue) {
+    if (newValue == value) return;
+
+    value = newValue;
+    valueText.setString(std::to_string(value));
+}
+
+void UiStepper::updateHover(sf::Vector2f mousePos) {
+    // Недоступный шаг не подсвечивается
+    minusButton.setHovered(minusButton.contains(mousePos) && allowed(-1));
+    plusButton.setHovered(plusButton.contains(mousePos) && allowed(1));
+}
+
+bool UiStepper::handleClick(sf::Vector2f mousePos) {
+    return minusButton.click(mousePos) || plusButton.click(mousePos);
+}
+
+void UiStepper::render(RenderQueue& queue) const {
+    queue.submit(nameText, RenderQueue::LAYER_TEXT);
+    queue.submit(valueText, RenderQueue::LAYER_TEXT);
+    minusButton.render(queue);
+    plusButton.render(queue);
+}
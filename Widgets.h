@@ -0,0 +1,166 @@
+﻿// Widgets.h
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RenderQueue.h"
+#include "SdfText.h"
+#include "TextureAtlas.h"
+
+// Общий набор виджетов интерфейса: кнопка, карточка с картинкой, строка выбора значения и степпер +/-.
+// Виджеты сами ничего не рисуют: render() отправляет вершины в RenderQueue. Рамки всех виджетов сцены,
+// картинки карточек из общего атласа и надписи одного размера уходят одним вызовом draw на текстуру.
+// Координаты — в единицах виртуального холста 1280x720
+
+// Картинки карточек в одной текстуре, чтобы карточки разных текстур рисовались одним пакетом
+class CardAtlas {
+public:
+    static CardAtlas& instance();
+
+    CardAtlas(const CardAtlas&) = delete;
+    CardAtlas& operator=(const CardAtlas&) = delete;
+
+    // Прямоугольник картинки textureId в атласе; при первом запросе картинка уменьшается
+    // до размера ячейки и копируется в атлас. nullopt, если текстура не загрузилась
+    std::optional<sf::IntRect> getRect(const std::string& textureId);
+    const sf::Texture& getTexture() const { return atlas.getTexture(); }
+
+    // Карточки на холсте не больше MAX_CARD_WIDTH x MAX_CARD_HEIGHT. Ячейка — их размер в пикселях
+    // при самом крупном масштабе вида из AVAILABLE_RESOLUTIONS, чтобы картинка не растягивалась на 4K;
+    // в окнах меньше ее уменьшают мип-уровни атласа
+    static constexpr float MAX_CARD_WIDTH = 200.f;
+    static constexpr float MAX_CARD_HEIGHT = 300.f;
+    static sf::Vector2u getCellSize();
+
+private:
+    // Три ячейки в ряд; отступ шире обычного, чтобы мип-уровни не смешивали соседние картинки
+    CardAtlas() : atlas({ 2048, 2048 }, 4) { atlas.setMipmapped(true); }
+
+    TextureAtlas atlas;
+    std::unordered_map<std::string, std::optional<sf::IntRect>> rects;
+};
+
+// Прямоугольная кнопка с надписью по центру
+class UiButton {
+public:
+    UiButton(const std::shared_ptr<SdfFont>& font, const std::string& label,
+        sf::Vector2f position = {}, sf::Vector2f size = { 30.f, 30.f }, unsigned int textSize = 20);
+
+    void setPosition(sf::Vector2f position);
+    void setSize(sf::Vector2f size);
+    void setLabel(const std::string& label);
+
+    bool contains(sf::Vector2f point) const;
+    void setHovered(bool hovered);
+    bool isHovered() const { return hovered; }
+
+    void setOnClick(std::function<void()> callback) { onClick = std::move(callback); }
+    // Вызывает обработчик, если точка внутри кнопки
+    bool click(sf::Vector2f point);
+
+    void render(RenderQueue& queue) const;
+
+private:
+    void centerLabel();
+
+    sf::RectangleShape shape;
+    SdfText label;
+    bool hovered = false;
+    std::function<void()> onClick;
+};
+
+// Карточка выбора: картинка из CardAtlas, рамка и подпись под ней
+class UiCard {
+public:
+    UiCard(const std::shared_ptr<SdfFont>& font, const std::string& label, const std::string& imageId);
+
+    void setPosition(sf::Vector2f position);
+    void setSize(sf::Vector2f size);
+    void setLabelSize(unsigned int size);
+
+    sf::FloatRect getBounds() const;
+    bool contains(sf::Vector2f point) const;
+    void setHovered(bool hovered);
+
+    const std::string& getLabel() const { return label; }
+    // Подпись отдается для глитч-эффекта сцены: призраки идут в тот же пакет текста
+    SdfText& getLabelText() { return labelText; }
+
+    void render(RenderQueue& queue) const;
+
+private:
+    std::string label;
+    std::optional<sf::Sprite> image;
+    sf::RectangleShape border;
+    SdfText labelText;
+};
+
+// Строка выбора из списка: "Название   Значение  < >"
+class UiSpinner {
+public:
+    UiSpinner(const std::shared_ptr<SdfFont>& font, const std::string& name, std::vector<std::string> options);
+
+    // Кнопки держат указатель на строку — не копируется и не перемещается
+    UiSpinner(const UiSpinner&) = delete;
+    UiSpinner& operator=(const UiSpinner&) = delete;
+
+    void setPosition(sf::Vector2f position);
+
+    // Выставляет значение и сообщает о нем обработчику, как при выборе кнопками
+    void setValue(int index);
+    int getValue() const { return currentIndex; }
+    void setOnValueChanged(std::function<void(int)> callback) { onValueChanged = std::move(callback); }
+
+    void updateHover(sf::Vector2f mousePos);
+    bool handleClick(sf::Vector2f mousePos);
+    void render(RenderQueue& queue) const;
+
+private:
+    void step(int delta);
+
+    std::vector<std::string> options;
+    int currentIndex = 0;
+
+    SdfText nameText;
+    SdfText valueText;
+    UiButton prevButton;
+    UiButton nextButton;
+    std::function<void(int)> onValueChanged;
+};
+
+// Числовое значение с кнопками "-" и "+". Само значение задает владелец через setValue:
+// кнопки только сообщают шаг, а доступность шага определяет canStep
+class UiStepper {
+public:
+    UiStepper(const std::shared_ptr<SdfFont>& font, const std::string& name);
+
+    UiStepper(const UiStepper&) = delete;
+    UiStepper& operator=(const UiStepper&) = delete;
+
+    void setPosition(sf::Vector2f position);
+
+    void setValue(int value);
+    int getValue() const { return value; }
+
+    void setOnStep(std::function<void(int)> callback) { onStep = std::move(callback); }
+    void setCanStep(std::function<bool(int)> predicate) { canStep = std::move(predicate); }
+
+    void updateHover(sf::Vector2f mousePos);
+    bool handleClick(sf::Vector2f mousePos);
+    void render(RenderQueue& queue) const;
+
+private:
+    bool allowed(int delta) const { return !canStep || canStep(delta); }
+
+    int value = 0;
+    SdfText nameText;
+    SdfText valueText;
+    UiButton minusButton;
+    UiButton plusButton;
+    std::function<void(int)> onStep;
+    std::function<bool(int)> canStep;
+};
@@ -14,39 +14,22 @@
 #include "CharacterSpecializationScene.h"
 #include "GlitchRenderer.h"
 #include "WorldCreationScene.h"
+#include "ResourceCache.h"
 
 WorldButton::WorldButton(GameConfig& config) : config(config) {
-    bool fontLoaded = false;
-
-    std::vector<std::string> fontPaths = {
-        "assets/fonts/digital-7 (italic).ttf",
-        "arial.ttf",
-        "../assets/fonts/arial.ttf",
-        "C:\\Windows\\Fonts\\arial.ttf",
-        "C:\\Windows\\Fonts\\calibri.ttf"
-    };
-
-    for (const auto& path : fontPaths) {
-        if (font.openFromFile(path)) { 
-            fontLoaded = true;
-            std::cout << "Font loaded successfully from: " << path << std::endl;
-            break;
-        }
-    }
-
-    if (!fontLoaded) {
-        std::cerr << "Warning: Could not load any font file. Text may not display correctly." << std::endl;
-    }
+    auto& cache = ResourceCache::instance();
+    font = cache.getFont("font.ui");
 
-    if (!backgroundTexture.loadFromFile("assets/textures/menu.png")) {
+    backgroundTexture = cache.getTexture("tex.menu");
+    if (backgroundTexture->getSize().x == 0) {
         std::cerr << "Failed to load background image.\n";
     }
     else {
-        backgroundSprite.emplace(backgroundTexture);
+        backgroundSprite.emplace(*backgroundTexture);
     }
 
     // ИСПРАВЛЕНО: В SFML 3 sf::Text требует font в конструкторе
-    WorldText = std::make_unique<sf::Text>(font, "CHOOSE THE WORLD TYPE");
+    WorldText = std::make_unique<sf::Text>(*font, "CHOOSE THE WORLD TYPE");
     WorldText->setCharacterSize(100);
     WorldText->setFillColor(sf::Color(139, 0, 0)); // setFillColor вместо setColor
     WorldText->setPosition(sf::Vector2f(10.f, 10.f));
@@ -55,14 +38,14 @@ WorldButton::WorldButton(GameConfig& config) : config(config) {
     menuItems.push_back(WorldText.get());
 
     // Загрузка кнопок (обновлено для хранения текстур)
-    for (const auto& [label, texturePath] : origins) {
-        auto tex = std::make_shared<sf::Texture>();
-        if (!tex->loadFromFile(texturePath)) {
-            std::cerr << "Failed to load texture for " << label << ": " << texturePath << std::endl;
+    for (const auto& [label, textureId] : origins) {
+        auto tex = cache.getTexture(textureId);
+        if (tex->getSize().x == 0) {
+            std::cerr << "Failed to load texture for " << label << ": " << textureId << std::endl;
         }
         textures.push_back(tex); // сохраняем чтобы не удалялись
 
-        WorldButton button(font);
+        WorldButton button(*font);
         button.setTexture(tex);
         button.label = label;
         button.labelText.setString(label);
@@ -95,7 +78,7 @@ void WorldButton::render(sf::RenderWindow& window) {
     std::cout << "Rendering background..." << std::endl;
     if (backgroundSprite.has_value()) {
         auto windowSize = window.getSize();
-        auto textureSize = backgroundTexture.getSize();
+        auto textureSize = backgroundTexture->getSize();
         float scaleX = static_cast<float>(windowSize.x) / textureSize.x;
         float scaleY = static_cast<float>(windowSize.y) / textureSize.y;
         float scale = std::max(scaleX, scaleY);
@@ -104,7 +87,7 @@ void WorldButton::render(sf::RenderWindow& window) {
     }
 
     std::cout << "Rendering glitch..." << std::endl;
-    glitchRenderer.renderBackground(window, backgroundTexture);
+    glitchRenderer.renderBackground(window, *backgroundTexture);
 
     std::cout << "Rendering origin text..." << std::endl;
     // Рендерим главный заголовок с глитч эффектом
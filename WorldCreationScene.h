@@ -60,17 +60,17 @@ class WorldType : public Scene {
 private:
 
     std::vector<std::pair<std::string, std::string>> worlds = {
-        {"Plot", "assets/textures/z.png"},
-        {"Free", "assets/textures/corpo.png"},
-        {"Superflat", "assets/textures/street.png"},
-        {"Custom", "assets/textures/tech.png" }
+        {"Plot", "tex.card.punk"},
+        {"Free", "tex.card.corpo"},
+        {"Superflat", "tex.card.street"},
+        {"Custom", "tex.card.tech" }
     };
 
-    sf::Texture backgroundTexture;
+    std::shared_ptr<sf::Texture> backgroundTexture;
     std::optional<sf::Sprite> backgroundSprite;
     std::vector<WorldButton> worldButton;
     std::vector<std::shared_ptr<sf::Texture>> textures; 
-    sf::Font font;
+    std::shared_ptr<sf::Font> font;
     GameConfig& config;
     std::unique_ptr<sf::Text> WorldText;
     GlitchRenderer glitchRenderer;
@@ -0,0 +1,172 @@
+﻿// AssetPacker.cpp
+// Офлайн-упаковщик ассетов в один файл для AssetArchive.
+// Использование (из папки игры): AssetPacker assets assets.pak
+// Имена в индексе — пути относительно папки игры ("assets/textures/menu.png"),
+// поэтому загрузчики ищут в архиве по тем же строкам, что и на диске.
+// AssetPacker --manifest assets assets.manifest пишет только список файлов для AssetManifest,
+// чтобы игра без архива не обходила папки при старте.
+// Сборка: g++ -std=c++17 -I.. AssetPacker.cpp ../AssetArchive.cpp -o AssetPacker
+#include "../AssetArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    struct PackedFile {
+        std::string name;
+        fs::path source;
+        std::uint64_t hash = 0;
+        std::uint64_t size = 0;
+        std::uint64_t offset = 0;
+        std::uint32_t nameOffset = 0;
+    };
+
+    std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    std::vector<PackedFile> collectFiles(const fs::path& root, const fs::path& outputAbsolute) {
+        std::vector<PackedFile> files;
+        for (const auto& item : fs::recursive_directory_iterator(root)) {
+            if (!item.is_regular_file()) continue;
+            // Сам архив может лежать внутри упаковываемой папки
+            if (fs::absolute(item.path()).lexically_normal() == outputAbsolute) continue;
+
+            PackedFile file;
+            file.source = item.path();
+            file.name = AssetArchive::normalizeName((root.filename() / fs::relative(item.path(), root)).generic_string());
+            file.hash = AssetArchive::hashName(file.name);
+            file.size = static_cast<std::uint64_t>(item.file_size());
+            files.push_back(std::move(file));
+        }
+        return files;
+    }
+
+    int writeManifest(const std::vector<PackedFile>& files, const fs::path& outputPath) {
+        std::vector<std::string> names;
+        for (const auto& file : files) names.push_back(file.name);
+        std::sort(names.begin(), names.end());
+
+        std::ofstream out(outputPath, std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "AssetPacker: cannot write " << outputPath << std::endl;
+            return 1;
+        }
+
+        out << "# Generated by AssetPacker --manifest, one path per line\n";
+        for (const auto& name : names) out << name << '\n';
+
+        std::cout << "AssetPacker: listed " << names.size() << " files in " << outputPath << std::endl;
+        return 0;
+    }
+
+    void writePadding(std::ofstream& out, std::uint64_t from, std::uint64_t to) {
+        static const char zeros[AssetArchive::DATA_ALIGNMENT] = {};
+        while (from < to) {
+            std::uint64_t chunk = std::min<std::uint64_t>(to - from, sizeof(zeros));
+            out.write(zeros, static_cast<std::streamsize>(chunk));
+            from += chunk;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    bool manifestOnly = argc > 1 && std::string(argv[1]) == "--manifest";
+    int first = manifestOnly ? 2 : 1;
+
+    if (argc < first + 2) {
+        std::cerr << "Usage: AssetPacker <assets-dir> <output.pak>" << std::endl;
+        std::cerr << "       AssetPacker --manifest <assets-dir> <output.manifest>" << std::endl;
+        return 1;
+    }
+
+    fs::path root = fs::path(argv[first]).lexically_normal();
+    if (root.filename().empty()) root = root.parent_path();
+    fs::path outputPath = argv[first + 1];
+    fs::path outputAbsolute = fs::absolute(outputPath).lexically_normal();
+
+    if (!fs::is_directory(root)) {
+        std::cerr << "AssetPacker: " << root << " is not a directory" << std::endl;
+        return 1;
+    }
+
+    std::vector<PackedFile> files = collectFiles(root, outputAbsolute);
+    if (manifestOnly) {
+        return writeManifest(files, outputPath);
+    }
+
+    // Индекс отсортирован по хешу: рантайм ищет бинарным поиском
+    std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+    });
+
+    for (std::size_t i = 1; i < files.size(); ++i) {
+        if (files[i].hash == files[i - 1].hash) {
+            std::cout << "AssetPacker: hash collision between '" << files[i - 1].name
+                << "' and '" << files[i].name << "' (resolved by name at runtime)" << std::endl;
+        }
+    }
+
+    // Раскладка: заголовок, индекс, имена, данные (каждый файл выровнен)
+    AssetArchive::Header header{};
+    std::memcpy(header.magic, "NCPK", 4);
+    header.version = AssetArchive::VERSION;
+    header.entryCount = static_cast<std::uint32_t>(files.size());
+    header.indexOffset = sizeof(AssetArchive::Header);
+    header.namesOffset = header.indexOffset + files.size() * sizeof(AssetArchive::Entry);
+
+    std::string namesBlock;
+    for (auto& file : files) {
+        file.nameOffset = static_cast<std::uint32_t>(namesBlock.size());
+        namesBlock += file.name;
+    }
+
+    std::uint64_t cursor = alignUp(header.namesOffset + namesBlock.size(), AssetArchive::DATA_ALIGNMENT);
+    for (auto& file : files) {
+        file.offset = cursor;
+        cursor = alignUp(cursor + file.size, AssetArchive::DATA_ALIGNMENT);
+    }
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "AssetPacker: cannot write " << outputPath << std::endl;
+        return 1;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& file : files) {
+        AssetArchive::Entry entry{};
+        entry.hash = file.hash;
+        entry.offset = file.offset;
+        entry.size = file.size;
+        entry.nameOffset = file.nameOffset;
+        entry.nameLength = static_cast<std::uint32_t>(file.name.size());
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    out.write(namesBlock.data(), static_cast<std::streamsize>(namesBlock.size()));
+
+    std::uint64_t written = header.namesOffset + namesBlock.size();
+    std::vector<char> buffer;
+    for (const auto& file : files) {
+        writePadding(out, written, file.offset);
+
+        std::ifstream in(file.source, std::ios::binary);
+        buffer.resize(static_cast<std::size_t>(file.size));
+        if (!in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+            std::cerr << "AssetPacker: failed to read " << file.source << std::endl;
+            return 1;
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        written = file.offset + file.size;
+    }
+
+    std::cout << "AssetPacker: packed " << files.size() << " files into " << outputPath
+        << " (" << written / 1024 << " KB)" << std::endl;
+    return 0;
+}